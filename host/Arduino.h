@@ -0,0 +1,141 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// ==================== 재생 호스트용 Arduino 코어 대역 ([env:native_replay]) ====================
+// 상태 머신(src/StateMachine.cpp)이 쓰는 것만: Print/Stream, F(), HIGH/LOW, Serial.
+// millis()/micros()/핀/레지스터는 일부러 없음 → 패스가 PassInputs 밖의 하드웨어를 보면 호스트 빌드가 깨짐.
+// 숫자 출력은 Arduino Print와 같은 방식 (float은 AVR처럼 32비트로 반올림/자릿수 뽑기) → swing/result 줄이 보드와 같은 글자.
+// ARDUINO는 정의하지 않음 (FastPin/EventLog 등은 시뮬레이션 쪽으로 컴파일).
+
+#define HIGH 0x1
+#define LOW  0x0
+#define DEC 10
+#define HEX 16
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+class Print
+{
+    private:
+        size_t printNumber(unsigned long n, uint8_t base)
+        {
+            char buf[8 * sizeof(long) + 1];
+            char* p = &buf[sizeof(buf) - 1];
+            *p = '\0';
+            if (base < 2) base = 10;
+            do
+            {
+                char c = n % base;
+                n /= base;
+                *--p = c < 10 ? c + '0' : c + 'A' - 10;
+            } while (n);
+            return write(p);
+        }
+
+        // Arduino printFloat과 같은 순서 (AVR double = float)
+        size_t printFloat(float number, uint8_t digits)
+        {
+            if (isnan(number)) return print("nan");
+            if (isinf(number)) return print("inf");
+            if (number > 4294967040.0f) return print("ovf");
+            if (number < -4294967040.0f) return print("ovf");
+
+            size_t n = 0;
+            if (number < 0.0f) { n += print('-'); number = -number; }
+            float rounding = 0.5f;
+            for (uint8_t i = 0; i < digits; ++i) rounding /= 10.0f;
+            number += rounding;
+
+            uint32_t intPart = (uint32_t)number;
+            float remainder = number - (float)intPart;
+            n += print((unsigned long)intPart);
+            if (digits > 0) n += print('.');
+            while (digits-- > 0)
+            {
+                remainder *= 10.0f;
+                unsigned int toPrint = (unsigned int)remainder;
+                n += print(toPrint);
+                remainder -= toPrint;
+            }
+            return n;
+        }
+
+    public:
+        virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buf, size_t size)
+    {
+        size_t n = 0;
+        while (size--) n += write(*buf++);
+        return n;
+    }
+    size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+
+    size_t print(const __FlashStringHelper* s) { return write(reinterpret_cast<const char*>(s)); }
+    size_t print(const char* s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char b, int base = DEC) { return print((unsigned long)b, base); }
+    size_t print(int n, int base = DEC) { return print((long)n, base); }
+    size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+    size_t print(long n, int base = DEC)
+    {
+        if (base == 10 && n < 0) return print('-') + printNumber(-(unsigned long)n, 10);
+        return printNumber((unsigned long)n, base);
+    }
+    size_t print(unsigned long n, int base = DEC) { return printNumber(n, base); }
+    size_t print(double n, int digits = 2) { return printFloat((float)n, digits); }
+
+    size_t println() { return write("\r\n"); }
+    template <class T> size_t println(T v) { size_t n = print(v); return n + println(); }
+    template <class T> size_t println(T v, int fmt) { size_t n = print(v, fmt); return n + println(); }
+};
+
+class Stream : public Print
+{
+    public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+};
+
+// Serial: 나가는 글자를 줄로 모아 onLine에 넘김 (재생 프로그램이 기록의 출력 줄과 비교). 들어오는 글자는 없음
+class HostSerial : public Stream
+{
+    private:
+        char _line[128];
+        size_t _len;
+
+    public:
+        void (*onLine)(const char* line);
+
+        HostSerial()
+        {
+            _len = 0;
+            onLine = nullptr;
+        }
+
+    size_t write(uint8_t c) override
+    {
+        if (c == '\r') return 1;
+        if (c == '\n')
+        {
+            _line[_len] = '\0';
+            _len = 0;
+            if (onLine) onLine(_line);
+            return 1;
+        }
+        if (_len < sizeof(_line) - 1) _line[_len++] = c;
+        return 1;
+    }
+    using Print::write;
+
+    int available() override { return 0; }
+    int read() override { return -1; }
+};
+
+extern HostSerial Serial;
@@ -0,0 +1,158 @@
+#pragma once
+#include <Arduino.h>
+#include "HysteresisQuantizer.h" // 팟 값 → 단계 (모드 상태에 들어가서 재생 호스트도 씀)
+
+// ==================== 프리런 ADC 엔진 ====================
+// analogRead()는 변환이 끝날 때까지 ~112us 블로킹함.
+// 여기서는 ADC를 free-running(clk/128 → 변환당 104us, 약 9.6kHz)으로 돌리고
+// ADC_vect ISR에서 채널별로 2^osLog2 샘플을 모아 12비트로 데시메이션 → 1차 IIR 필터.
+// loop에서는 value()로 최신 필터값을 기다림 없이 읽음 (0~4095).
+// 채널마다 weight(변환 슬롯 수)를 줘서 빠른 신호(AS5600 OUT)에 변환을 더 배분할 수 있음.
+// weight 0 = 변환 안 함 (setWeight()로 돌리는 중에도 바꿈). 슬롯표에 채널이 하나뿐이면 free-running 대신
+// Timer0 오버플로(≈976Hz)로 변환을 시작 → 느린 신호(팟)만 남았을 때 ISR이 9.6kHz → 1kHz.
+//
+// free-running에서는 ISR 시점에 다음 변환이 이미 시작돼 있으므로 ADMUX 변경은
+// 그 다음 변환부터 적용됨 → _resultCh/_nextCh 두 단계로 채널을 추적.
+class AdcEngine
+{
+    public:
+        static constexpr uint8_t MAX_CHANNELS = 2;
+        static constexpr uint8_t MAX_SLOTS = 8;
+        static constexpr uint8_t NONE = 0xFF;
+
+    private:
+        struct Channel
+        {
+            uint8_t mux;          // ADC0~5
+            uint8_t osLog2;       // 오버샘플 2^n (0~6, 0 = 평균 없이 매 변환)
+            uint8_t filterShift;  // IIR 계수 1/2^n (0 = 필터 없음)
+            uint8_t count;
+            uint16_t acc;
+            uint32_t filt;        // value << filterShift
+            volatile uint16_t out;
+            volatile uint8_t seq; // 새 값이 나올 때마다 증가
+            uint8_t weight;       // 슬롯 수 (0 = 변환 안 함)
+        };
+
+        Channel _ch[MAX_CHANNELS];
+        uint8_t _numCh;
+        uint8_t _sched[MAX_SLOTS]; // 슬롯 → 채널
+        uint8_t _numSlots;
+        uint8_t _slot;
+        uint8_t _resultCh;
+        uint8_t _nextCh;
+
+        static uint8_t admuxFor(uint8_t mux) { return _BV(REFS0) | (mux & 0x07); } // 기준전압 AVcc
+
+        void schedule()
+        {
+            _numSlots = 0;
+            for (uint8_t i = 0; i < _numCh; i++)
+                for (uint8_t w = _ch[i].weight; w && _numSlots < MAX_SLOTS; w--) _sched[_numSlots++] = i;
+        }
+
+    public:
+        AdcEngine()
+        {
+            _numCh = 0;
+            _numSlots = 0;
+            _slot = 0;
+            _resultCh = 0;
+            _nextCh = 0;
+        }
+
+    // begin() 전에 호출. 리턴값 = 채널 번호
+    uint8_t addChannel(uint8_t pin, uint8_t osLog2, uint8_t filterShift, uint8_t weight = 1)
+    {
+        if (_numCh >= MAX_CHANNELS) return _numCh - 1;
+        Channel& c = _ch[_numCh];
+        c.mux = pin >= A0 ? pin - A0 : pin;
+        c.osLog2 = osLog2 > 6 ? 6 : osLog2;
+        c.filterShift = filterShift;
+        c.count = 0;
+        c.acc = 0;
+        c.filt = 0;
+        c.out = 0;
+        c.seq = 0;
+        c.weight = weight;
+        schedule();
+        return _numCh++;
+    }
+
+    void begin()
+    {
+        if (_numSlots == 0) return;
+        for (uint8_t i = 0; i < _numCh; i++)
+        {
+            DIDR0 |= _BV(_ch[i].mux); // 디지털 입력 버퍼 끔
+            _ch[i].count = 0;         // 이전 슬롯표로 모으던 것은 버림 (필터값은 유지)
+            _ch[i].acc = 0;
+        }
+
+        // 채널 하나면 변환이 끝난 뒤 다음 트리거까지 ~1ms라 ADMUX 파이프라인(_nextCh)도 그 채널 하나
+        bool paced = _sched[0] == _sched[_numSlots - 1];
+        _slot = 0;
+        _resultCh = _sched[0];
+        _nextCh = _sched[0];
+        ADMUX = admuxFor(_ch[_sched[0]].mux);
+        ADCSRB = paced ? _BV(ADTS2) : 0;                              // 자동 트리거 = Timer0 오버플로 / free running
+        ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE)
+               | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);                // clk/128
+        if (!paced) ADCSRA |= _BV(ADSC);
+    }
+
+    // 채널 변환 몫 바꾸기 (0 = 빼기). 돌고 있었으면 멈추고 새 슬롯표로 다시 시작
+    void setWeight(uint8_t ch, uint8_t weight)
+    {
+        bool running = ADCSRA & _BV(ADEN);
+        ADCSRA = _BV(ADIF); // ADC/ISR 끔 + 끝난 변환 표시 지움 (다시 켤 때 옛 결과로 ISR이 돌지 않게)
+        _ch[ch].weight = weight;
+        schedule();
+        if (running) begin();
+    }
+
+    // 최신 필터값 (12비트). 16비트 읽기라 인터럽트 잠깐 막음
+    uint16_t value(uint8_t ch) const
+    {
+        uint8_t sreg = SREG;
+        cli();
+        uint16_t v = _ch[ch].out;
+        SREG = sreg;
+        return v;
+    }
+
+    uint8_t seq(uint8_t ch) const { return _ch[ch].seq; }
+
+    // ADC_vect ISR에서 호출. 새 데시메이션 값이 나온 채널 번호 (없으면 NONE) 리턴
+    uint8_t isr()
+    {
+        uint8_t done = NONE;
+        uint16_t raw = ADC;
+        Channel& c = _ch[_resultCh];
+
+        c.acc += raw;
+        if (++c.count >> c.osLog2)
+        {
+            uint16_t dec = c.osLog2 >= 2 ? c.acc >> (c.osLog2 - 2) : c.acc << (2 - c.osLog2); // → 12비트
+            c.acc = 0;
+            c.count = 0;
+
+            if (c.filterShift == 0) c.filt = dec;
+            else if (c.seq == 0)    c.filt = (uint32_t)dec << c.filterShift; // 첫 값으로 초기화
+            else                    c.filt += dec - (c.filt >> c.filterShift);
+
+            c.out = (uint16_t)(c.filt >> c.filterShift);
+            c.seq++;
+            if (c.seq == 0) c.seq = 1;
+            done = _resultCh;
+        }
+
+        // 슬롯 순회: 방금 시작된 변환 = _nextCh, 그 다음 변환 채널을 지금 ADMUX에 씀
+        _resultCh = _nextCh;
+        if (++_slot >= _numSlots) _slot = 0;
+        uint8_t n = _sched[_slot];
+        if (n != _nextCh) ADMUX = admuxFor(_ch[n].mux);
+        _nextCh = n;
+        return done;
+    }
+};
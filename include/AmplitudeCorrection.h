@@ -0,0 +1,27 @@
+#pragma once
+#include <Arduino.h>
+#include <math.h>
+
+// ==================== 유한 진폭 주기 보정 ====================
+// 진폭 theta0로 흔들 때 주기 T = T0 * (1 + sum c_n k^(2n)),  k = sin(theta0 / 2)
+//   c_n = ((2n-1)!! / (2n)!!)^2 = 1/4, 9/64, 25/256, 1225/16384, 3969/65536 ...
+// 5항이면 45도에서도 남는 오차가 1e-6 아래 (k^2 <= 0.146).
+// 관성모멘트 식(I = T^2 M g D / 4pi^2)은 작은 각 주기 T0를 쓰므로 측정 주기를 이 값으로 나눠서 씀.
+// (작은 각 근사를 그대로 쓰면 25도에서 T가 약 1.2% 길게 나오고 I는 약 2.4% 크게 나옴)
+namespace ampcorr
+{
+    constexpr uint8_t TERMS = 5;
+    constexpr float SERIES[TERMS] = { 1.0f / 4, 9.0f / 64, 25.0f / 256, 1225.0f / 16384, 3969.0f / 65536 };
+
+    // T(theta0) / T0
+    inline float periodFactor(float amplitudeDeg)
+    {
+        float k = sin(amplitudeDeg * (float)(M_PI / 360.0)); // sin(theta0 / 2)
+        float k2 = k * k;
+        float f = 0.0;
+        for (int8_t i = TERMS - 1; i >= 0; i--) f = (f + SERIES[i]) * k2; // Horner
+        return 1.0 + f;
+    }
+
+    inline float toSmallAngle(float period, float amplitudeDeg) { return period / periodFactor(amplitudeDeg); }
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <Arduino.h>
+#include "As5600Lean.h"
+
+// ==================== 각도 샘플 스트림 ====================
+// I2C(readAngle) 경로와 AS5600 OUT 아날로그 경로가 같은 형식의 샘플을 냄.
+//   raw: 0~4095 (12비트, 360도), tUs: micros() 타임스탬프
+// ANALOG: ADC ISR이 pushSample()로 수 kHz 샘플을 넣음 (I2C 버스를 전혀 안 씀)
+//         A0 변환 슬롯은 ANALOG일 때만 → 소스는 selectAngleSource()로 바꿈 (ADC 슬롯표도 같이)
+// I2C   : poll() 할 때마다 한 번 읽어서 넣음 (I2cBus 스케줄러가 주기적으로 호출)
+// 자석 상태가 나쁘면(magnetOk() = false) 어느 경로든 샘플을 넣지 않음.
+struct AngleSample
+{
+    uint32_t tUs;
+    uint16_t raw;
+};
+
+class AngleSource
+{
+    public:
+        enum Kind : uint8_t { SRC_I2C = 0, SRC_ANALOG = 1 };
+
+    private:
+        static constexpr uint8_t QUEUE_SIZE = 32; // 2의 거듭제곱 (7.2kHz 아날로그 경로 ≈ 4.4ms 분량)
+
+        As5600Lean& _sensor;
+        volatile uint8_t _kind;
+        AngleSample _queue[QUEUE_SIZE];
+        volatile uint8_t _head;
+        volatile uint8_t _tail;
+        volatile uint16_t _latest;
+        volatile uint32_t _dropped;
+
+        void push(uint32_t t, uint16_t raw)
+        {
+            _latest = raw;
+            uint8_t next = (_head + 1) & (QUEUE_SIZE - 1);
+            if (next == _tail) { _dropped++; return; } // 소비자가 느리면 최신 값만 유지
+            _queue[_head].tUs = t;
+            _queue[_head].raw = raw;
+            _head = next;
+        }
+
+    public:
+        AngleSource(As5600Lean& sensor) : _sensor(sensor)
+        {
+#ifdef ANGLE_SOURCE_ANALOG
+            _kind = SRC_ANALOG;
+#else
+            _kind = SRC_I2C;
+#endif
+            _head = 0;
+            _tail = 0;
+            _latest = 0;
+            _dropped = 0;
+        }
+
+    Kind kind() const { return (Kind)_kind; }
+
+    void select(Kind k)
+    {
+        uint8_t sreg = SREG;
+        cli();
+        _kind = k;
+        _tail = _head; // 다른 경로 샘플이 섞이지 않게 비움
+        SREG = sreg;
+    }
+
+    // ADC ISR에서 호출 (아날로그 경로일 때만 넣음)
+    void pushSample(uint16_t raw)
+    {
+        if (_kind == SRC_ANALOG && _sensor.magnetOk()) push(micros(), raw);
+    }
+
+    // I2C 경로면 한 번 읽어서 스트림에 넣음. 읽기 실패면 false
+    bool poll()
+    {
+        if (_kind != SRC_I2C) return true;
+        uint16_t raw;
+        if (!_sensor.readAngle(raw)) return false;
+        if (!_sensor.magnetOk()) return true; // 버스는 정상, 값만 버림
+        uint8_t sreg = SREG;
+        cli();
+        push(micros(), raw);
+        SREG = sreg;
+        return true;
+    }
+
+    // 최신 각도 (기다리지 않음. I2C 경로 샘플은 I2cBus가 주기적으로 poll() 해서 채움)
+    uint16_t latest() const
+    {
+        uint8_t sreg = SREG;
+        cli();
+        uint16_t v = _latest;
+        SREG = sreg;
+        return v;
+    }
+
+    bool pop(AngleSample& s)
+    {
+        uint8_t sreg = SREG;
+        cli();
+        bool ok = _tail != _head;
+        if (ok)
+        {
+            s = _queue[_tail];
+            _tail = (_tail + 1) & (QUEUE_SIZE - 1);
+        }
+        SREG = sreg;
+        return ok;
+    }
+
+    uint32_t dropped() const { return _dropped; }
+};
+
+extern AngleSource angleSource;
+
+// 각도 소스 + ADC 슬롯표 같이 바꾸기 (main.cpp)
+void selectAngleSource(AngleSource::Kind k);
@@ -0,0 +1,128 @@
+#pragma once
+#include <Arduino.h>
+#include <Wire.h>
+
+// ==================== AS5600 경량 드라이버 ====================
+// 라이브러리 readAngle()은 매번 레지스터 주소를 다시 쓰고(write + repeated start) 읽음.
+// AS5600은 ANGLE/RAW ANGLE/MAGNITUDE 레지스터에서 주소 포인터가 자동 증가하지 않으므로
+// 포인터를 RAW ANGLE(0x0C)에 한 번 세워두면 이후에는 2바이트 읽기만으로 계속 읽을 수 있음.
+// 자석 상태(STATUS/AGC)는 매 샘플이 아니라 STATUS_EVERY 번마다만 확인 → magnetOk()로 게이트.
+class As5600Lean
+{
+    public:
+        static constexpr uint8_t ADDRESS = 0x36;
+        static constexpr uint16_t STATUS_EVERY = 256; // 1kHz 읽기 기준 약 0.25s
+
+        // STATUS 비트
+        static constexpr uint8_t STATUS_MH = 0x08; // 자석 너무 강함
+        static constexpr uint8_t STATUS_ML = 0x10; // 자석 너무 약함
+        static constexpr uint8_t STATUS_MD = 0x20; // 자석 감지
+
+    private:
+        static constexpr uint8_t REG_CONF_H    = 0x07;
+        static constexpr uint8_t REG_STATUS    = 0x0B;
+        static constexpr uint8_t REG_RAW_ANGLE = 0x0C;
+        static constexpr uint8_t REG_AGC       = 0x1A;
+
+        // CONF (0x07:0x08)
+        //   SF   = 00  : slow filter 16x (스텝 응답 2.2ms, 노이즈 최소) - 진자 주기(~1s)에 비해 충분히 빠름
+        //   FTH  = 001 : 6 LSB 넘게 움직이면 fast filter (놓는 순간 같은 큰 변화는 바로 따라감)
+        //   HYST = 00  : 출력 히스테리시스 끔 (작은 진폭 피크가 뭉개지지 않게)
+        //   OUTS = 00  : OUT 핀 아날로그 0~VDD (A0 고속 경로용)
+        //   PM   = 00  : 상시 동작
+        static constexpr uint8_t CONF_H = (0x1 << 2) | 0x0; // FTH | SF
+        static constexpr uint8_t CONF_L = 0x00;             // PWMF | OUTS | HYST | PM
+
+        TwoWire& _wire;
+        bool _parked;
+        uint16_t _sinceStatus;
+        uint8_t _status;
+        uint8_t _agc;
+
+        bool writeReg(uint8_t reg, const uint8_t* data, uint8_t n)
+        {
+            _parked = false;
+            _wire.beginTransmission(ADDRESS);
+            _wire.write(reg);
+            for (uint8_t i = 0; i < n; i++) _wire.write(data[i]);
+            return _wire.endTransmission() == 0;
+        }
+
+        bool readReg(uint8_t reg, uint8_t* data, uint8_t n)
+        {
+            _parked = false;
+            _wire.beginTransmission(ADDRESS);
+            _wire.write(reg);
+            if (_wire.endTransmission(false) != 0) return false;
+            if (_wire.requestFrom(ADDRESS, n) != n) return false;
+            for (uint8_t i = 0; i < n; i++) data[i] = _wire.read();
+            return true;
+        }
+
+        bool park()
+        {
+            _wire.beginTransmission(ADDRESS);
+            _wire.write(REG_RAW_ANGLE);
+            _parked = _wire.endTransmission() == 0;
+            return _parked;
+        }
+
+    public:
+        As5600Lean(TwoWire& wire) : _wire(wire)
+        {
+            _parked = false;
+            _sinceStatus = 0;
+            _status = 0;
+            _agc = 0;
+        }
+
+    // 방향 핀 LOW = 시계방향 증가
+    void begin(uint8_t dirPin)
+    {
+        pinMode(dirPin, OUTPUT);
+        digitalWrite(dirPin, LOW);
+    }
+
+    uint8_t getAddress() const { return ADDRESS; }
+
+    bool isConnected()
+    {
+        _parked = false;
+        _wire.beginTransmission(ADDRESS);
+        return _wire.endTransmission() == 0;
+    }
+
+    // 필터/출력 설정 (휘발성, 번(burn) 안 함) + 상태 확인 + 포인터 파킹
+    bool configure()
+    {
+        uint8_t conf[2] = { CONF_H, CONF_L };
+        if (!writeReg(REG_CONF_H, conf, 2)) return false;
+        return checkStatus();
+    }
+
+    // STATUS/AGC 읽고 다시 RAW ANGLE에 파킹
+    bool checkStatus()
+    {
+        _sinceStatus = 0;
+        if (!readReg(REG_STATUS, &_status, 1)) return false;
+        if (!readReg(REG_AGC, &_agc, 1)) return false;
+        return park();
+    }
+
+    // 파킹돼 있으면 2바이트 읽기 한 번. 실패하면 false
+    bool readAngle(uint16_t& raw)
+    {
+        if (++_sinceStatus >= STATUS_EVERY && !checkStatus()) return false;
+        if (!_parked && !park()) return false;
+        if (_wire.requestFrom(ADDRESS, (uint8_t)2) != 2) { _parked = false; return false; }
+        uint8_t hi = _wire.read();
+        uint8_t lo = _wire.read();
+        raw = ((uint16_t)(hi & 0x0F) << 8) | lo;
+        return true;
+    }
+
+    // 마지막 확인 기준: 자석 감지됨 + 세기 정상 범위
+    bool magnetOk() const { return (_status & (STATUS_MD | STATUS_ML | STATUS_MH)) == STATUS_MD; }
+    uint8_t status() const { return _status; }
+    uint8_t agc() const { return _agc; }
+};
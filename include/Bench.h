@@ -0,0 +1,8 @@
+#pragma once
+
+// ==================== 온보드 벤치마크 ====================
+// [env:uno_bench] (-DBENCH) 빌드에서만 setup() 끝에 한 번 실행.
+// 결과는 Serial에 "bench,<항목>,<단위>,<값>" 형식으로 한 줄씩 출력.
+#ifdef BENCH
+void runBenchmarks();
+#endif
@@ -0,0 +1,114 @@
+#pragma once
+#include <Arduino.h>
+#include "FastPin.h"
+
+// ==================== 버튼 이벤트 ====================
+enum ButtonEventType : uint8_t
+{
+    BTN_PRESS   = 1,
+    BTN_RELEASE = 2,
+    BTN_LONG    = 3
+};
+
+struct ButtonEvent
+{
+    uint8_t pin;   // Arduino 핀 번호
+    uint8_t type;  // ButtonEventType
+};
+
+// ==================== 일괄 디바운서 (vertical counter) ====================
+// 타이머 틱(ISR)에서 tick()을 부르면 ScanDivider 틱마다 포트를 한 번만 읽어
+// 모든 버튼을 비트 병렬로 디바운싱함. 2비트 vertical counter → 4회 연속 같은 값이면 확정.
+//   (Timer0 COMPB 틱 1.024ms x 10 x 4 ≈ 41ms, 기존 50ms 디바운스와 비슷)
+// 버튼은 INPUT_PULLUP, 눌리면 LOW. 모든 핀은 같은 포트에 있어야 함.
+template <uint8_t ScanDivider, uint8_t LongScans, uint8_t FirstPin, uint8_t... Pins>
+class ButtonScanner
+{
+    private:
+        static constexpr uint8_t PORT_ID = pinmap::port(FirstPin);
+        static constexpr uint8_t MASK = pinmap::MaskOf<FirstPin, Pins...>::value;
+        static constexpr uint8_t QUEUE_SIZE = 8; // 2의 거듭제곱
+
+        static_assert(PORT_ID != pinmap::PORT_ID_NONE, "ButtonScanner: invalid pin");
+        static_assert(pinmap::AllOnPort<PORT_ID, Pins...>::value, "ButtonScanner: all pins must share one port");
+
+        // ISR 전용 상태
+        uint8_t _divider;
+        uint8_t _state;      // 디바운싱된 상태 (1 = 눌림)
+        uint8_t _ct0, _ct1;  // vertical counter
+        uint8_t _held[8];    // 비트별 누른 시간 (스캔 단위), 롱프레스 판정용
+
+        // ISR → loop 이벤트 큐 (단일 생산자/소비자)
+        volatile uint8_t _head;
+        volatile uint8_t _tail;
+        uint8_t _queue[QUEUE_SIZE];
+
+        void push(uint8_t b, uint8_t type)
+        {
+            uint8_t next = (_head + 1) & (QUEUE_SIZE - 1);
+            if (next == _tail) return; // 가득 차면 버림
+            _queue[_head] = (uint8_t)(type << 6) | pinmap::pinOf(PORT_ID, b);
+            _head = next;
+        }
+
+    public:
+        ButtonScanner()
+        {
+            _divider = 0;
+            _state = 0;
+            _ct0 = 0xFF;
+            _ct1 = 0xFF;
+            for (uint8_t i = 0; i < 8; i++) _held[i] = 0;
+            _head = 0;
+            _tail = 0;
+        }
+
+    void begin()
+    {
+        int expand[] = { (FastPin<FirstPin>::inputPullup(), 0), (FastPin<Pins>::inputPullup(), 0)... };
+        (void)expand;
+    }
+
+    // 타이머 ISR에서 호출
+    void tick()
+    {
+        if (++_divider < ScanDivider) return;
+        _divider = 0;
+
+        uint8_t sample = (uint8_t)~pinmap::Regs<PORT_ID>::in() & MASK;
+        uint8_t changed = _state ^ sample;
+
+        _ct0 = ~(_ct0 & changed);
+        _ct1 = _ct0 ^ (_ct1 & changed);
+        changed &= _ct0 & _ct1;
+        _state ^= changed;
+
+        for (uint8_t b = 0; b < 8; b++)
+        {
+            uint8_t m = (uint8_t)(1 << b);
+            if (!(MASK & m)) continue;
+
+            if (changed & m)
+            {
+                _held[b] = 0;
+                push(b, (_state & m) ? BTN_PRESS : BTN_RELEASE);
+            }
+            else if ((_state & m) && _held[b] < LongScans)
+            {
+                if (++_held[b] == LongScans) push(b, BTN_LONG);
+            }
+        }
+    }
+
+    // loop에서 호출: 이벤트가 있으면 꺼내고 true
+    bool poll(ButtonEvent& ev)
+    {
+        uint8_t tail = _tail;
+        if (tail == _head) return false;
+        uint8_t raw = _queue[tail];
+        _tail = (tail + 1) & (QUEUE_SIZE - 1);
+        ev.pin = raw & 0x3F;
+        ev.type = raw >> 6;
+        return true;
+    }
+};
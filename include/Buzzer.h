@@ -0,0 +1,102 @@
+#pragma once
+#include <Arduino.h>
+#include "Pins.h"
+
+// ==================== 부저 시퀀서 ====================
+// tone()은 Timer2 토글 ISR을 주파수의 2배로 돌려 측정 중 엣지 타임스탬프를 흔듦.
+// 여기서는 BUZZER_PIN(9) = OC1A 이므로 Timer1 Fast PWM(TOP=ICR1)으로 파형을 하드웨어가 만들고
+// (음 재생 중 ISR 0개), 길이만 1.024ms 틱(Timer0 COMPB)에서 tick()으로 센다.
+// play()는 큐에 넣고 바로 리턴 → 여러 음을 연달아 넣으면 순서대로 재생.
+// 재생 호스트([env:native_replay])에서는 큐만 (소리/틱 없음, 가득 차면 play()가 버림).
+static_assert(BUZZER_PIN == 9, "Buzzer: hardware tone needs OC1A (D9)");
+
+struct Note
+{
+    uint16_t freq; // Hz, 0 = 쉼표
+    uint16_t ms;
+};
+
+class BuzzerSequencer
+{
+    private:
+        static constexpr uint8_t QUEUE_SIZE = 8; // 2의 거듭제곱
+
+        Note _queue[QUEUE_SIZE];
+        volatile uint8_t _head;       // loop에서만 씀
+        volatile uint8_t _tail;       // ISR에서만 씀
+        volatile uint16_t _remaining; // 현재 음 남은 틱
+
+#ifdef ARDUINO
+        static void startTone(uint16_t freq)
+        {
+            if (freq < 31) { stopTone(); return; } // 프리스케일러 8에서 16비트 TOP 한계
+
+            uint16_t top = (uint16_t)((F_CPU / 8UL) / freq - 1);
+            TCCR1B = 0;
+            ICR1 = top;
+            OCR1A = top / 2;
+            TCNT1 = 0;
+            TCCR1A = _BV(COM1A1) | _BV(WGM11);               // OC1A 비반전 출력
+            TCCR1B = _BV(WGM13) | _BV(WGM12) | _BV(CS11);    // Fast PWM, clk/8
+        }
+
+        static void stopTone()
+        {
+            TCCR1A = 0;
+            TCCR1B = 0;
+            BuzzerPin::low();
+        }
+#endif
+
+    public:
+        BuzzerSequencer()
+        {
+            _head = 0;
+            _tail = 0;
+            _remaining = 0;
+        }
+
+#ifdef ARDUINO
+    void begin()
+    {
+        BuzzerPin::output();
+        stopTone();
+    }
+#endif
+
+    // loop에서 호출. 큐가 가득 차면 버림 (측정 타이밍이 우선)
+    bool play(uint16_t freq, uint16_t ms)
+    {
+        uint8_t next = (_head + 1) & (QUEUE_SIZE - 1);
+        if (next == _tail) return false;
+        _queue[_head].freq = freq;
+        _queue[_head].ms = ms;
+        _head = next;
+        return true;
+    }
+
+    bool isIdle() const { return _remaining == 0 && _head == _tail; }
+
+#ifdef ARDUINO
+    // Timer0 COMPB ISR에서 1.024ms마다 호출
+    void tick()
+    {
+        if (_remaining && --_remaining) return;
+
+        uint8_t tail = _tail;
+        if (tail == _head)
+        {
+            if (TCCR1B) stopTone();
+            return;
+        }
+
+        const Note& n = _queue[tail];
+        startTone(n.freq);
+        uint16_t ticks = (uint16_t)(((uint32_t)n.ms * 125UL) >> 7); // ms → 1.024ms 틱
+        _remaining = ticks ? ticks : 1;
+        _tail = (tail + 1) & (QUEUE_SIZE - 1);
+    }
+#endif
+};
+
+extern BuzzerSequencer buzzer;
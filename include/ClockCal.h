@@ -0,0 +1,99 @@
+#pragma once
+#include <Arduino.h>
+#ifdef ARDUINO
+#include <EEPROM.h>
+#endif
+#include <math.h>
+
+// ==================== 시간 기준 보정 (세라믹 레조네이터 오차) ====================
+// Uno의 16MHz 레조네이터는 수백~수천 ppm 틀리고 온도로도 움직임 → micros()로 잰 주기가 그만큼 틀리고
+// I = T^2 M g D / 4pi^2 는 그 두 배로 틀림.
+// tools/clock_cal.py가 Serial 'S'로 몇 분 동안 시각을 주고받아서 회귀로 ppm을 구하고 'K'로 저장:
+//   ppm = (보드 micros() 속도 / 호스트 시계 속도 - 1) * 1e6   (+ = 보드 시계가 빠름 → 주기가 길게 나옴)
+// 보드 us → 실제 s: us / (1 + ppm * 1e-6) / 1e6  (주기를 초로 바꾸는 곳은 모두 toSec()을 씀)
+// EEPROM 0번지에 { MAGIC, ppm } (put = 바뀐 바이트만 씀). 없거나 범위 밖이면 보정 없음 (0 ppm).
+// 세션 기록은 "rec,begin" 바로 뒤에 "clk,<ppm>"을 남기고, 재생 빌드는 EEPROM 대신 그 값을 씀
+// (다른 보드에서 재생하거나 다시 보정한 뒤에도 swing/result 줄이 같게). 재생 호스트에는 EEPROM 쪽이 없음.
+#define CLOCK_CAL_EEPROM_ADDR 0
+
+class ClockCal
+{
+    private:
+        struct Stored
+        {
+            uint16_t magic;
+            float ppm;
+        };
+        static constexpr uint16_t MAGIC = 0xC1CA;
+
+        float _ppm;
+        float _secPerUs;
+
+        void set(float ppm)
+        {
+            _ppm = ppm;
+            _secPerUs = 1.0e-6 / (1.0 + ppm * 1.0e-6);
+        }
+
+    public:
+        static constexpr float MAX_PPM = 20000.0; // 2%: 이보다 크면 레조네이터 오차가 아니라 측정 실패
+
+        static bool valid(float ppm) { return !isnan(ppm) && fabs(ppm) <= MAX_PPM; }
+
+        ClockCal() { set(0.0); }
+
+#ifdef ARDUINO
+    // EEPROM에서 읽음 (setup에서 한 번)
+    void begin()
+    {
+        Stored s;
+        EEPROM.get(CLOCK_CAL_EEPROM_ADDR, s);
+        if (s.magic == MAGIC && valid(s.ppm)) set(s.ppm);
+    }
+
+    // 새 값 적용 + EEPROM에 저장. 범위 밖이면 false (저장값 그대로)
+    bool store(float ppm)
+    {
+        if (!valid(ppm)) return false;
+        set(ppm);
+        Stored s = { MAGIC, ppm };
+        EEPROM.put(CLOCK_CAL_EEPROM_ADDR, s);
+        return true;
+    }
+#endif
+
+    // "850.25" 같은 글자열 전체가 숫자이고 범위 안일 때만 true
+    static bool parse(const char* text, float& ppm)
+    {
+        char* end;
+        ppm = strtod(text, &end);
+        return end != text && *end == '\0' && valid(ppm);
+    }
+
+#ifdef ARDUINO
+    // 글자열로 저장. 비었거나 숫자가 아니면 false (저장값 그대로)
+    bool storeText(const char* text)
+    {
+        float ppm;
+        return parse(text, ppm) && store(ppm);
+    }
+#endif
+
+    // EEPROM은 그대로 두고 이번에만 씀 (재생: 기록한 보드의 값)
+    void use(float ppm) { set(ppm); }
+
+#ifdef ARDUINO
+    // 보정 지우기 (EEPROM 표시도 지움 → 다음 부팅도 0 ppm)
+    void clear()
+    {
+        set(0.0);
+        Stored s = { 0xFFFF, 0.0 };
+        EEPROM.put(CLOCK_CAL_EEPROM_ADDR, s);
+    }
+#endif
+
+    float ppm() const { return _ppm; }
+
+    // 보드 micros() 간격 → 실제 초
+    float toSec(float us) const { return us * _secPerUs; }
+};
@@ -0,0 +1,80 @@
+#pragma once
+#include <Arduino.h>
+#include <math.h>
+
+// ==================== 감쇠 (로그 감소율) 추정 ====================
+// 피크 진폭 A_k (k = 반주기 번호, 양쪽 피크 절댓값)에 대해 ln A_k = a + b*k 를 점진적 최소제곱으로 맞춤.
+//   로그 감소율 delta = -2b (왕복 1번당), 감쇠비 zeta = delta / sqrt(4pi^2 + delta^2), Q = pi / delta
+// 합은 k와 ln(A_k / A_0)로 쌓아서 float(32비트)에서도 자릿수가 남게 함.
+// 모든 필드가 0이면 빈 상태 (reset() = memset).
+class DecayEstimator
+{
+    private:
+        uint8_t _n;
+        float _lnA0;               // 첫 피크 ln A
+        float _sk, _skk, _sy, _sky; // y = ln A_k - ln A_0
+
+        float slope() const
+        {
+            float den = _n * _skk - _sk * _sk;
+            return den > 0 ? (_n * _sky - _sk * _sy) / den : 0.0;
+        }
+
+    public:
+    void reset() { memset(this, 0, sizeof(*this)); }
+
+    // 다음 피크 진폭 (deg)
+    void add(float amplitude)
+    {
+        if (amplitude <= 0) return;
+        float lnA = log(amplitude);
+        if (_n == 0) _lnA0 = lnA;
+        float k = _n;
+        float y = lnA - _lnA0;
+        _sk += k;
+        _skk += k * k;
+        _sy += y;
+        _sky += k * y;
+        _n++;
+    }
+
+    uint8_t count() const { return _n; }
+    bool ready() const { return _n >= 4; }
+
+    float logDecrement() const { return -2.0 * slope(); }
+
+    float dampingRatio() const
+    {
+        float d = logDecrement();
+        return d / sqrt(4.0 * M_PI * M_PI + d * d);
+    }
+
+    // 감쇠가 거의 없으면(delta <= 0) 0 리턴 (= 측정 못 함)
+    float qFactor() const
+    {
+        float d = logDecrement();
+        return d > 0 ? M_PI / d : 0.0;
+    }
+
+    // 맞춘 직선 위 k번째(0 = 첫 피크, 소수 가능) 피크 진폭
+    float amplitudeAt(float k) const
+    {
+        if (_n == 0) return 0.0;
+        float b = slope();
+        float a = (_sy - b * _sk) / _n;
+        return exp(_lnA0 + a + b * k);
+    }
+
+    // 맞춘 직선 위 지금(마지막 피크) 진폭
+    float amplitudeNow() const { return amplitudeAt(_n - 1); }
+
+    // 진폭이 threshold 아래로 떨어지기 전까지 남은 왕복 수 (감쇠 없으면 큰 값)
+    float swingsLeft(float threshold) const
+    {
+        float d = logDecrement();
+        float now = amplitudeNow();
+        if (now <= threshold) return 0.0;
+        if (d <= 0) return 1000.0;
+        return log(now / threshold) / d;
+    }
+};
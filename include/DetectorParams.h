@@ -0,0 +1,86 @@
+#pragma once
+
+// ==================== 검출기 임계값 ====================
+// 자동 생성: tools/tune_detector.py (손으로 고치지 말고 다시 생성)
+// 각 값은 빌드 플래그로 덮어쓸 수 있음 (예: -DDET_HALL_PEAK_DEG=10)
+
+// hall 파레토 집합 (miss, false, ttr_s):
+//   arm_deg=4 ema_old=0.40 peak_deg=6 -> 0.056 0.001 17.055
+//   arm_deg=2 ema_old=0.20 peak_deg=6 -> 0.058 0.004 17.027
+//   arm_deg=4 ema_old=0.20 peak_deg=6 -> 0.058 0.004 17.027
+//   arm_deg=4 ema_old=0.60 peak_deg=6 -> 0.058 0.000 17.074
+//   arm_deg=2 ema_old=0.00 peak_deg=6 -> 0.068 0.016 16.991
+//   arm_deg=4 ema_old=0.00 peak_deg=6 -> 0.068 0.016 16.991
+//   arm_deg=2 ema_old=0.20 peak_deg=8 -> 0.155 0.001 16.868
+//   arm_deg=4 ema_old=0.20 peak_deg=8 -> 0.155 0.001 16.868
+//   arm_deg=6 ema_old=0.20 peak_deg=8 -> 0.155 0.001 16.868
+//   arm_deg=4 ema_old=0.40 peak_deg=8 -> 0.157 0.000 16.942
+//   arm_deg=6 ema_old=0.40 peak_deg=8 -> 0.157 0.000 16.942
+//   arm_deg=2 ema_old=0.00 peak_deg=8 -> 0.160 0.006 16.839
+//   arm_deg=4 ema_old=0.00 peak_deg=8 -> 0.160 0.006 16.839
+//   arm_deg=6 ema_old=0.00 peak_deg=8 -> 0.160 0.006 16.839
+//   arm_deg=2 ema_old=0.20 peak_deg=10 -> 0.250 0.000 16.629
+//   arm_deg=4 ema_old=0.20 peak_deg=10 -> 0.250 0.000 16.629
+//   arm_deg=6 ema_old=0.20 peak_deg=10 -> 0.250 0.000 16.629
+//   arm_deg=8 ema_old=0.20 peak_deg=10 -> 0.250 0.000 16.629
+//   arm_deg=2 ema_old=0.00 peak_deg=10 -> 0.250 0.003 16.598
+//   arm_deg=4 ema_old=0.00 peak_deg=10 -> 0.250 0.003 16.598
+//   arm_deg=6 ema_old=0.00 peak_deg=10 -> 0.250 0.003 16.598
+//   arm_deg=8 ema_old=0.00 peak_deg=10 -> 0.250 0.003 16.598
+//   arm_deg=2 ema_old=0.00 peak_deg=12 -> 0.355 0.001 16.500
+//   arm_deg=4 ema_old=0.00 peak_deg=12 -> 0.355 0.001 16.500
+//   arm_deg=6 ema_old=0.00 peak_deg=12 -> 0.355 0.001 16.500
+//   arm_deg=8 ema_old=0.00 peak_deg=12 -> 0.355 0.001 16.500
+//   arm_deg=10 ema_old=0.00 peak_deg=12 -> 0.355 0.001 16.500
+//   arm_deg=2 ema_old=0.20 peak_deg=12 -> 0.358 0.000 16.529
+//   arm_deg=4 ema_old=0.20 peak_deg=12 -> 0.358 0.000 16.529
+//   arm_deg=6 ema_old=0.20 peak_deg=12 -> 0.358 0.000 16.529
+//   arm_deg=8 ema_old=0.20 peak_deg=12 -> 0.358 0.000 16.529
+//   arm_deg=10 ema_old=0.20 peak_deg=12 -> 0.358 0.000 16.529
+//   arm_deg=4 ema_old=0.40 peak_deg=12 -> 0.361 0.000 16.483
+//   arm_deg=6 ema_old=0.40 peak_deg=12 -> 0.361 0.000 16.483
+//   arm_deg=8 ema_old=0.40 peak_deg=12 -> 0.361 0.000 16.483
+//   arm_deg=10 ema_old=0.40 peak_deg=12 -> 0.361 0.000 16.483
+//   arm_deg=2 ema_old=0.00 peak_deg=14 -> 0.455 0.001 16.246
+//   arm_deg=4 ema_old=0.00 peak_deg=14 -> 0.455 0.001 16.246
+//   arm_deg=6 ema_old=0.00 peak_deg=14 -> 0.455 0.001 16.246
+//   arm_deg=8 ema_old=0.00 peak_deg=14 -> 0.455 0.001 16.246
+//   arm_deg=10 ema_old=0.00 peak_deg=14 -> 0.455 0.001 16.246
+//   arm_deg=2 ema_old=0.20 peak_deg=14 -> 0.457 0.000 16.267
+//   arm_deg=4 ema_old=0.20 peak_deg=14 -> 0.457 0.000 16.267
+//   arm_deg=6 ema_old=0.20 peak_deg=14 -> 0.457 0.000 16.267
+//   arm_deg=8 ema_old=0.20 peak_deg=14 -> 0.457 0.000 16.267
+//   arm_deg=10 ema_old=0.20 peak_deg=14 -> 0.457 0.000 16.267
+//   arm_deg=4 ema_old=0.40 peak_deg=14 -> 0.460 0.000 16.151
+//   arm_deg=6 ema_old=0.40 peak_deg=14 -> 0.460 0.000 16.151
+//   arm_deg=8 ema_old=0.40 peak_deg=14 -> 0.460 0.000 16.151
+//   arm_deg=10 ema_old=0.40 peak_deg=14 -> 0.460 0.000 16.151
+#ifndef DET_HALL_ARM_DEG
+#define DET_HALL_ARM_DEG         4      // currentIntAngle < 이 값 → 다음 피크 준비
+#endif
+#ifndef DET_HALL_PEAK_DEG
+#define DET_HALL_PEAK_DEG        6      // prevIntAngle > 이 값에서 내려가면 피크
+#endif
+#ifndef DET_HALL_EMA_OLD
+#define DET_HALL_EMA_OLD         0.40   // 각도 EMA: 이전 값 가중치 (새 값 = 1 - 이 값)
+#endif
+
+// goto 파레토 집합 (lock_s, amp_err_deg):
+//   hold_ms=500 tol_deg=5.00 -> 1.127 1.042
+//   hold_ms=500 tol_deg=4.00 -> 1.215 0.987
+//   hold_ms=500 tol_deg=3.00 -> 1.358 0.814
+//   hold_ms=500 tol_deg=2.00 -> 1.697 0.696
+#ifndef DET_GOTO_TOL_DEG
+#define DET_GOTO_TOL_DEG         2.00   // 목표 각도 허용 오차
+#endif
+#ifndef DET_GOTO_HOLD_MS
+#define DET_GOTO_HOLD_MS         500    // 허용 오차 안에서 버틸 시간
+#endif
+
+// photo 파레토 집합 (miss, false):
+//   debounce_ms=50 -> 0.000 0.000
+//   debounce_ms=100 -> 0.000 0.000
+//   debounce_ms=200 -> 0.000 0.000
+#ifndef DET_PHOTO_DEBOUNCE_MS
+#define DET_PHOTO_DEBOUNCE_MS    50     // 포토 통과 디바운스
+#endif
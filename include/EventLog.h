@@ -0,0 +1,162 @@
+#pragma once
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h> // [env:native] 단위 테스트 (test/test_eventlog)
+#include <string.h>
+#endif
+
+// ==================== 이벤트 타임스탬프 로그 (델타 압축) ====================
+// 통과/피크 시각을 4바이트씩 저장하지 않고, 예측 간격과의 차이(잔차)만 가변 길이로 저장.
+//   예측 간격 = 두 개 전 간격 (포토 게이트가 중심에서 벗어나 짧은/긴 반주기가 번갈아 나와도 맞음)
+//   잔차 → zigzag → 7비트 varint : 지터가 ±63틱(4us 단위 ±252us) 안이면 1바이트, 대부분 1~2바이트
+// CheckpointEvery 개마다 체크포인트(버퍼 위치 + 절대 시각)를 따로 둬서
+// at(i)는 처음부터가 아니라 가장 가까운 체크포인트부터만 풀면 됨. 체크포인트 이벤트 자체는 0바이트.
+// micros()는 16MHz에서 4us 단위라 TickShift = 2면 손실 없음 (간격의 하위 비트는 버림).
+// 모든 필드가 0이면 빈 로그 → 공용체/memset 초기화 그대로 사용 가능.
+template <uint16_t Bytes, uint8_t CheckpointEvery = 32, uint8_t TickShift = 2>
+class EventLog
+{
+    public:
+        static_assert(CheckpointEvery >= 2, "EventLog: checkpoint interval too small");
+        // 체크포인트가 아닌 이벤트는 최소 1바이트 → 블록 수 상한
+        static constexpr uint16_t MAX_CHECKPOINTS = Bytes / (CheckpointEvery - 1) + 2;
+
+    private:
+        struct Checkpoint
+        {
+            uint16_t offset; // 이 블록 첫 잔차의 버퍼 위치
+            uint32_t tUs;    // 블록 첫 이벤트의 절대 시각
+        };
+
+        uint8_t _data[Bytes];
+        Checkpoint _cp[MAX_CHECKPOINTS];
+        uint16_t _used;
+        uint16_t _count;
+        uint32_t _lastUs;
+        uint32_t _d1, _d2; // 직전 / 두 개 전 간격 (틱), 체크포인트에서 0으로
+
+        static uint32_t predict(uint32_t d1, uint32_t d2) { return d2 ? d2 : d1; }
+
+        static uint32_t zigzag(int32_t r) { return ((uint32_t)r << 1) ^ (uint32_t)(r >> 31); }
+        static int32_t unzigzag(uint32_t z) { return (int32_t)(z >> 1) ^ -(int32_t)(z & 1); }
+
+        uint32_t getVarint(uint16_t& off) const
+        {
+            uint32_t v = 0;
+            uint8_t shift = 0;
+            uint8_t b;
+            do
+            {
+                b = _data[off++];
+                v |= (uint32_t)(b & 0x7F) << shift;
+                shift += 7;
+            } while (b & 0x80);
+            return v;
+        }
+
+    public:
+        // 순차 읽기 (한 이벤트당 varint 하나만 풂)
+        class Reader
+        {
+            private:
+                const EventLog& _log;
+                uint16_t _i;
+                uint16_t _off;
+                uint32_t _tUs;
+                uint32_t _d1, _d2;
+
+            public:
+                Reader(const EventLog& log, uint16_t from = 0) : _log(log)
+                {
+                    _i = from - from % CheckpointEvery;
+                    _off = 0;
+                    _tUs = 0;
+                    _d1 = 0;
+                    _d2 = 0;
+                    uint32_t t;
+                    while (_i < from && next(t)) {}
+                }
+
+            bool next(uint32_t& tUs)
+            {
+                if (_i >= _log._count) return false;
+                if (_i % CheckpointEvery == 0)
+                {
+                    const Checkpoint& c = _log._cp[_i / CheckpointEvery];
+                    _off = c.offset;
+                    _tUs = c.tUs;
+                    _d1 = 0;
+                    _d2 = 0;
+                }
+                else
+                {
+                    uint32_t d = predict(_d1, _d2) + (uint32_t)unzigzag(_log.getVarint(_off));
+                    _tUs += d << TickShift;
+                    _d2 = _d1;
+                    _d1 = d;
+                }
+                _i++;
+                tUs = _tUs;
+                return true;
+            }
+        };
+
+    void clear() { memset(this, 0, sizeof(*this)); }
+
+    uint16_t count() const { return _count; }
+    uint16_t bytesUsed() const { return _used; }
+    bool empty() const { return _count == 0; }
+
+    // 가득 차면 false (이미 저장된 이벤트는 그대로)
+    bool append(uint32_t tUs)
+    {
+        if (_count % CheckpointEvery == 0)
+        {
+            uint16_t c = _count / CheckpointEvery;
+            if (c >= MAX_CHECKPOINTS) return false;
+            _cp[c].offset = _used;
+            _cp[c].tUs = tUs;
+            _d1 = 0;
+            _d2 = 0;
+        }
+        else
+        {
+            uint32_t d = (tUs - _lastUs) >> TickShift; // micros() 넘침에도 안전
+            uint32_t z = zigzag((int32_t)(d - predict(_d1, _d2)));
+
+            uint8_t len = 1;
+            for (uint32_t v = z >> 7; v; v >>= 7) len++;
+            if (_used + len > Bytes) return false;
+
+            while (z >= 0x80)
+            {
+                _data[_used++] = (uint8_t)(z | 0x80);
+                z >>= 7;
+            }
+            _data[_used++] = (uint8_t)z;
+            _d2 = _d1;
+            _d1 = d;
+            tUs = _lastUs + (d << TickShift); // 읽을 때와 같은 값으로 누적 (하위 비트 오차가 쌓이지 않게)
+        }
+        _lastUs = tUs;
+        _count++;
+        return true;
+    }
+
+    // i번째 이벤트 시각 (us). 범위 밖이면 0
+    uint32_t at(uint16_t i) const
+    {
+        uint32_t t = 0;
+        Reader r(*this, i);
+        r.next(t);
+        return t;
+    }
+
+    uint32_t first() const { return at(0); }
+    uint32_t last() const { return _count ? _lastUs : 0; } // append()가 복원값으로 누적하므로 at(count()-1)과 같음
+};
+
+// Mode 3/5 측정 로그 (main.cpp)
+typedef EventLog<384> RunLog; // 1~2바이트/이벤트 → 수백 개
+extern RunLog runLog;
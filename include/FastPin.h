@@ -0,0 +1,48 @@
+#pragma once
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h> // [env:native] 시뮬레이션 포트 (test/test_fastpin)
+#endif
+#include "PinMap.h"
+
+// ==================== 컴파일 타임 핀 ====================
+// digitalRead/digitalWrite는 핀 번호 → 포트 테이블을 런타임에 찾느라 수 us가 걸림.
+// FastPin<PIN>은 포트/비트가 컴파일 타임에 정해져 read()는 in+and, high()/low()는 sbi/cbi 1개.
+// 잘못된 핀 번호는 static_assert로 빌드 에러.
+template <uint8_t Pin>
+struct FastPin
+{
+    static constexpr uint8_t PORT_ID = pinmap::port(Pin);
+    static constexpr uint8_t MASK = pinmap::mask(Pin);
+    typedef pinmap::Regs<PORT_ID> R;
+
+    static_assert(PORT_ID != pinmap::PORT_ID_NONE, "FastPin: invalid pin (Uno: 0~19)");
+
+    static inline bool read()  { return (R::in() & MASK) != 0; }
+    static inline void high()  { R::out() |= MASK; }
+    static inline void low()   { R::out() &= (uint8_t)~MASK; }
+    static inline void write(bool v) { if (v) high(); else low(); }
+
+    static inline void toggle()
+    {
+#ifdef __AVR__
+        R::in() = MASK;  // PINx에 1 쓰기 = 토글 (ATmega328P 하드웨어 기능)
+#else
+        R::out() ^= MASK;
+#endif
+    }
+
+    static inline void output()      { R::ddr() |= MASK; }
+    static inline void input()       { R::ddr() &= (uint8_t)~MASK; low(); }
+    static inline void inputPullup() { R::ddr() &= (uint8_t)~MASK; high(); }
+
+#ifndef __AVR__
+    // native 빌드용: 시뮬레이션 포트에 입력 레벨 주입
+    static inline void simSet(bool v)
+    {
+        if (v) R::in() |= MASK;
+        else   R::in() &= (uint8_t)~MASK;
+    }
+#endif
+};
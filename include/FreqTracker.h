@@ -0,0 +1,105 @@
+#pragma once
+#include <Arduino.h>
+#include <math.h>
+
+// ==================== 각도 스트림 주기 추적 ====================
+// 피크 검출은 반주기에 시각 하나만 남기고 나머지 샘플은 버림. 여기서는 스트림 전체로 주기를 추정.
+// 1) 칸 평균: 샘플(수 kHz/1 kHz, 불규칙)을 BinUs(기본 50ms) 칸으로 평균 → 등간격 20Hz 신호 x (Q4 counts = 1/16 count)
+// 2) 차분 d = x[n] - x[n-1]: 0점(오프셋) 오차를 없앰. 감쇠 진동이면 d도 같은 주파수의 정현파
+// 3) 정현파는 d[m+k] + d[m-k] = 2cos(k w) d[m] (Goertzel 공진기 계수 관계). 이것을 k = 2, 4로 누적:
+//      A2 = sum d[m] (d[m+2] + d[m-2]) = 2cos(2w) P,   A4 = sum d[m] (d[m+4] + d[m-4]) = 2cos(4w) P
+//    (sum = 칸마다 1/2^Shift씩 잊는 누적, 정수). 잡음은 차분 때문에 이웃 칸끼리만 상관 → 시차 2, 4는 치우침 없음.
+//    r = A4 / A2 = cos4w / cos2w,  c = cos2w = (r + sqrt(r^2 + 8)) / 4,  T = 4 pi BinUs / acos(c)
+// 관계식이 샘플마다 정확히 성립하므로 창 길이(기본 32칸 = 1.6s)는 잡음 평균만 정함 → 1~2 왕복이면 수렴.
+// 같은 곱을 잊지 않고 float으로도 누적 → runPeriodUs()는 측정 시작부터 전체 스트림 추정 (왕복이 늘수록 정밀).
+// 칸마다(20Hz) 갱신. 샘플 하나당 일은 덧셈/비교 몇 개, float은 칸 닫을 때 sqrt/acos 한 번씩.
+// 칸 하나가 통째로 비면(센서 끊김) 차분 이력을 처음부터 다시 채움 (누적값은 유지).
+// int32 누적 범위: 주기 0.8s 이상이면 진폭 45도까지 넘치지 않음 (진자 시뮬레이션 범위 0.8~2.4s).
+template <uint32_t BinUs = 50000, uint8_t Shift = 5>
+class FreqTracker
+{
+    private:
+        static constexpr uint8_t HIST = 9; // d[m-4] ~ d[m+4]
+
+        uint32_t _binStart;
+        int32_t _binSum;
+        uint16_t _binN;
+        bool _started;
+
+        int16_t _prevMean;     // 직전 칸 평균 (Q4 counts)
+        bool _prevValid;
+        int16_t _d[HIST];      // _d[0] = 최신 차분
+        uint8_t _filled;
+
+        int32_t _a2, _a4;      // 최근 창 (잊는 누적)
+        float _s2, _s4;        // 시작부터 전체
+        uint16_t _updates;     // 누적에 들어간 칸 수
+        float _periodUs;
+        float _runPeriodUs;
+
+        static float solve(float a2, float a4)
+        {
+            if (a2 <= 0) return 0.0; // 2w >= 90도 (한 주기 8칸 미만) 이거나 아직 신호 없음
+            float r = a4 / a2;
+            float c = (r + sqrt(r * r + 8.0)) * 0.25;
+            if (c >= 1.0) return 0.0;
+            return 4.0 * M_PI * BinUs / acos(c);
+        }
+
+        void closeBin()
+        {
+            if (_binN == 0) // 빈 칸: 이력 다시 채움
+            {
+                _prevValid = false;
+                _filled = 0;
+                return;
+            }
+            int16_t mean = (int16_t)(_binSum * 16 / (int32_t)_binN);
+            _binSum = 0;
+            _binN = 0;
+            if (!_prevValid) { _prevMean = mean; _prevValid = true; return; }
+
+            int16_t d = mean - _prevMean;
+            _prevMean = mean;
+            for (uint8_t i = HIST - 1; i > 0; i--) _d[i] = _d[i - 1];
+            _d[0] = d;
+            if (_filled < HIST) { _filled++; if (_filled < HIST) return; }
+
+            int32_t m = _d[4];
+            int32_t p2 = m * ((int32_t)_d[2] + _d[6]);
+            int32_t p4 = m * ((int32_t)_d[0] + _d[8]);
+            _a2 += p2 - (_a2 >> Shift);
+            _a4 += p4 - (_a4 >> Shift);
+            _s2 += p2;
+            _s4 += p4;
+            if (_updates < 0xFFFF) _updates++;
+
+            float t = solve(_a2, _a4);
+            if (t > 0) _periodUs = t;
+            t = solve(_s2, _s4);
+            if (t > 0) _runPeriodUs = t;
+        }
+
+    public:
+    void reset() { memset(this, 0, sizeof(*this)); }
+
+    // 샘플 하나 (tUs: micros(), counts: 0점 기준 부호 있는 각도, 12비트 = 360도)
+    void push(uint32_t tUs, int16_t counts)
+    {
+        if (!_started) { _binStart = tUs; _started = true; }
+        while (tUs - _binStart >= BinUs)
+        {
+            closeBin();
+            _binStart += BinUs;
+        }
+        _binSum += counts;
+        _binN++;
+    }
+
+    // 최근 창 주기 추정 (us, 칸마다 갱신). 아직 없으면 0
+    float periodUs() const { return _periodUs; }
+
+    // reset() 이후 전체 스트림 주기 추정 (us). 아직 없으면 0
+    float runPeriodUs() const { return _runPeriodUs; }
+    uint16_t updates() const { return _updates; }
+};
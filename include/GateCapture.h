@@ -0,0 +1,88 @@
+#pragma once
+#include <Arduino.h>
+#include "FastPin.h"
+
+// ==================== 포토 게이트 엣지 캡처 (핀 변화 인터럽트) ====================
+// loop()가 포토 핀을 폴링하면 엣지 시각이 패스 시작 시각(수 ms~20ms 늦음)으로 찍힘.
+// 여기서는 핀 변화 인터럽트(PCINT)에서 빔이 막히는 엣지(HIGH → LOW)마다 micros()를 바로 찍어
+// 작은 큐에 넣고, loop는 패스마다 poll()로 꺼냄. Mode 5(Hall)가 각도 스트림을 보는 동안에도
+// 게이트 통과 시각이 따로 쌓이므로 한 번 흔들어서 두 센서 주기를 같이 얻음.
+// 디바운스: 마지막으로 받은 엣지에서 debounceUs 안의 엣지는 버림 (빔 가장자리 채터).
+// ISR 벡터(PCINTx_vect)는 main.cpp에서 핀 포트에 맞춰 isr()를 부름.
+template <uint8_t Pin, uint8_t QueueSize = 4>
+class GateCapture
+{
+    private:
+        static constexpr uint8_t PORT_ID = pinmap::port(Pin);
+        static constexpr uint8_t MASK = pinmap::mask(Pin);
+
+        static_assert(PORT_ID != pinmap::PORT_ID_NONE, "GateCapture: invalid pin");
+        static_assert((QueueSize & (QueueSize - 1)) == 0, "GateCapture: queue size must be a power of 2");
+
+        // ISR 전용 상태
+        uint32_t _debounceUs;
+        uint32_t _lastUs;
+        bool _any;
+
+        // ISR → loop 큐 (단일 생산자/소비자)
+        volatile uint8_t _head;
+        volatile uint8_t _tail;
+        volatile uint32_t _queue[QueueSize];
+        volatile uint8_t _dropped; // 큐가 가득 차서 버린 엣지 수
+
+    public:
+        GateCapture()
+        {
+            _debounceUs = 0;
+            _lastUs = 0;
+            _any = false;
+            _head = 0;
+            _tail = 0;
+            _dropped = 0;
+        }
+
+    // 포트에 맞는 PCMSK 비트 + PCICR 그룹을 켬 (핀 모드는 따로 설정)
+    void begin(uint32_t debounceUs)
+    {
+        _debounceUs = debounceUs;
+#ifdef __AVR__
+        switch (PORT_ID)
+        {
+            case pinmap::PORT_ID_B: PCMSK0 |= MASK; PCIFR = _BV(PCIF0); PCICR |= _BV(PCIE0); break;
+            case pinmap::PORT_ID_C: PCMSK1 |= MASK; PCIFR = _BV(PCIF1); PCICR |= _BV(PCIE1); break;
+            case pinmap::PORT_ID_D: PCMSK2 |= MASK; PCIFR = _BV(PCIF2); PCICR |= _BV(PCIE2); break;
+        }
+#endif
+    }
+
+    // PCINTx_vect에서 호출 (같은 포트 다른 핀의 변화로도 불릴 수 있음 → 레벨로 판단)
+    void isr()
+    {
+        if (FastPin<Pin>::read()) return; // 빔 열림 (올라가는 엣지) 무시
+        uint32_t now = micros();
+        if (_any && now - _lastUs < _debounceUs) return;
+        _lastUs = now;
+        _any = true;
+
+        uint8_t next = (_head + 1) & (QueueSize - 1);
+        if (next == _tail) { _dropped++; return; }
+        _queue[_head] = now;
+        _head = next;
+    }
+
+    // 엣지가 있으면 시각을 꺼내고 true
+    bool poll(uint32_t& tUs)
+    {
+        if (_tail == _head) return false;
+        tUs = _queue[_tail];
+        _tail = (_tail + 1) & (QueueSize - 1);
+        return true;
+    }
+
+    void clear()
+    {
+        _tail = _head;
+    }
+
+    uint8_t dropped() const { return _dropped; }
+};
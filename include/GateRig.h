@@ -0,0 +1,11 @@
+#pragma once
+
+// ==================== 다중 게이트 측정대 ====================
+// [env:uno_gates] (-DMULTI_GATE) 빌드에서 setup()이 AS5600/LCD 대신 이것을 부르고 돌아오지 않음.
+// 게이트(GATE_RIG_PINS)마다 진자 하나: 왕복 주기를 따로 쌓아서 채널별로 결과를 Serial에 냄.
+//   "rig,<채널>,<핀>,<실행>,<왕복 수>,<T_s>,<sT_s>,<버린 엣지 수>"
+#ifdef MULTI_GATE
+#include "ClockCal.h"
+
+void runGateRig(const ClockCal& clk); // 주기는 clk로 보정 (값은 일반 빌드에서 Serial 'K'로 EEPROM에 저장)
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+
+// ==================== 히스테리시스 양자화 ====================
+// 0~full 값을 steps 단계로 나누되, 경계를 hyst 만큼 넘어가야 단계가 바뀜
+// (팟 값이 경계에서 떨리면서 숫자가 깜빡이는 것 방지)
+class HysteresisQuantizer
+{
+    private:
+        uint16_t _full;
+        uint16_t _steps;
+        uint16_t _hyst;
+        int16_t _level;
+
+        uint16_t edge(uint16_t level) const { return (uint16_t)(((uint32_t)level * (_full + 1UL)) / _steps); }
+
+    public:
+        HysteresisQuantizer() = default; // 공용체(모드 상태)에 넣을 수 있게 trivial 유지, configure()로 설정
+
+        HysteresisQuantizer(uint16_t full, uint16_t steps, uint16_t hyst)
+        {
+            configure(full, steps, hyst);
+        }
+
+    void configure(uint16_t full, uint16_t steps, uint16_t hyst)
+    {
+        _full = full;
+        _steps = steps;
+        _hyst = hyst;
+        _level = -1;
+    }
+
+    void reset() { _level = -1; }
+    int16_t level() const { return _level; }
+
+    // 새 단계를 리턴
+    int16_t update(uint16_t v)
+    {
+        int16_t raw = (int16_t)(((uint32_t)v * _steps) / (_full + 1UL));
+        if (raw >= (int16_t)_steps) raw = _steps - 1;
+
+        if (_level < 0) _level = raw;
+        else if (raw > _level && v >= edge(_level + 1) + _hyst) _level = raw;
+        else if (raw < _level && v + _hyst < edge(_level)) _level = raw;
+        return _level;
+    }
+};
@@ -0,0 +1,322 @@
+#pragma once
+#include <Arduino.h>
+#include <Wire.h>
+#include "AngleSource.h"
+#include "ShadowLcd.h"
+
+// ==================== I2C 버스 스케줄러 ====================
+// AS5600와 LCD가 Wire 하나를 공유하므로 loop에서 service()만 부르고 직접 버스를 쓰지 않음.
+//   1순위: 센서 읽기 (I2C 각도 경로일 때 SENSOR_PERIOD_US 마다)
+//   2순위: LCD 바뀐 칸 한 글자 - 다음 센서 읽기 전까지 끝날 것 같을 때만
+// 트랜잭션 경계에서만 양보하므로 센서 대기시간은 최대 LCD 한 글자 분량.
+// 센서 읽기마다 (실제 시작 - 예정 시각)을 log2 히스토그램에 기록.
+// 클럭: AS5600 400kHz, LCD(PCF8574)는 100kHz까지라 장치별로 바꿔 씀.
+//
+// 행(hang) 대책: 모든 트랜잭션에 Wire 타임아웃(TIMEOUT_US).
+//   타임아웃 → SCL 9클럭 + STOP으로 버스 해제 → Wire 재시작 → LCD/AS5600 재초기화.
+//   AS5600만 응답이 없으면 (연속 실패) 버스는 그대로 두고 센서만 다시 찾음.
+//   둘 다 실패하면 백오프(10ms → 최대 5s, 2배씩)로 재시도.
+//   AS5600이 없는 동안 sensorAvailable() = false → 포토 전용 모드로 동작.
+class I2cBus
+{
+    public:
+        static constexpr uint8_t HIST_BUCKETS = 12;   // [0,64) [64,128) ... [65ms,∞) us
+        static constexpr uint32_t SENSOR_CLOCK = 400000UL;
+        static constexpr uint32_t LCD_CLOCK = 100000UL;
+        static constexpr uint32_t TIMEOUT_US = 3000UL;
+        static constexpr uint8_t SENSOR_FAIL_LIMIT = 5;         // 연속 실패 → 복구
+        static constexpr uint16_t BACKOFF_MIN_MS = 10;
+        static constexpr uint16_t BACKOFF_MAX_MS = 5000;
+        static constexpr uint16_t HEALTH_PROBE_MS = 1000;      // 아날로그 경로일 때 AS5600 생존 확인
+        static constexpr uint8_t LCD_STARVE_PERIODS = 4;       // 글자가 센서 사이에 안 들어가도 이만큼 기다리면 한 글자 보냄
+
+    private:
+        AngleSource& _angle;
+        As5600Lean& _sensor;
+        ShadowLcd& _lcd;
+        uint16_t _periodUs;
+        uint32_t _nextDue;
+        uint16_t _lcdCharUs;      // LCD 한 글자 전송 시간 추정 (측정값 EMA, 0 = 아직 못 잼)
+        uint8_t _lcdWaitPeriods;  // LCD가 더러운 채로 지나간 센서 주기 수
+        uint32_t _lcdFlushes;
+        uint32_t _clock;
+        uint16_t _hist[HIST_BUCKETS];
+        uint32_t _maxWaitUs;
+
+        bool _sensorOk;
+        bool _lcdOk;
+        bool _busFault;
+        uint8_t _sensorFails;
+        uint16_t _busBackoffMs;
+        uint32_t _busRetryAtMs;
+        uint16_t _sensorBackoffMs;
+        uint32_t _sensorRetryAtMs;
+        uint32_t _lastProbeMs;
+
+        uint16_t _timeouts;
+        uint16_t _recoveries;
+        uint16_t _recoveryFailures;
+
+        void useClock(uint32_t hz)
+        {
+            if (_clock == hz) return;
+            Wire.setClock(hz);
+            _clock = hz;
+        }
+
+        void record(uint32_t waitUs)
+        {
+            uint8_t b = 0;
+            uint32_t w = waitUs >> 6;
+            while (w && b < HIST_BUCKETS - 1) { w >>= 1; b++; }
+            if (_hist[b] < 0xFFFF) _hist[b]++;
+            if (waitUs > _maxWaitUs) _maxWaitUs = waitUs;
+        }
+
+        // 트랜잭션 직후 호출: 타임아웃이 났으면 복구 예약
+        bool checkTimeout()
+        {
+            if (!Wire.getWireTimeoutFlag()) return false;
+            Wire.clearWireTimeoutFlag();
+            _timeouts++;
+            if (!_busFault)
+            {
+                _busFault = true;
+                _busBackoffMs = BACKOFF_MIN_MS;
+                _busRetryAtMs = millis();
+            }
+            return true;
+        }
+
+        void sensorLost()
+        {
+            _sensorOk = false;
+            _sensorBackoffMs = BACKOFF_MIN_MS;
+            _sensorRetryAtMs = millis() + BACKOFF_MIN_MS;
+        }
+
+        static uint16_t nextBackoff(uint16_t ms)
+        {
+            return ms >= BACKOFF_MAX_MS / 2 ? BACKOFF_MAX_MS : ms * 2;
+        }
+
+        static bool probe(uint8_t addr)
+        {
+            Wire.beginTransmission(addr);
+            return Wire.endTransmission() == 0 && !Wire.getWireTimeoutFlag();
+        }
+
+        // open-drain 흉내: LOW = PORT 비트를 먼저 0으로 (입력인 채로 → 풀업만 꺼짐) 한 뒤 출력으로,
+        // 놓기 = 입력으로 (선은 모듈의 풀업이 올림). 순서를 바꾸면 INPUT_PULLUP의 PORT=1이 그대로 남아
+        // 잠깐 HIGH를 push-pull로 내보냄 → 선을 LOW로 잡고 있는 슬레이브와 맞부딪힘.
+        static void lineLow(uint8_t pin)
+        {
+            digitalWrite(pin, LOW);
+            pinMode(pin, OUTPUT);
+        }
+
+        static void lineRelease(uint8_t pin) { pinMode(pin, INPUT); }
+
+        // 슬레이브가 SDA를 잡고 있으면 SCL을 최대 9번 흔들어 풀고 STOP 생성 (A4 = SDA, A5 = SCL)
+        static void releaseBus()
+        {
+            Wire.end();
+            lineRelease(SDA);
+            lineRelease(SCL);
+            delayMicroseconds(10);
+
+            for (uint8_t i = 0; i < 9 && digitalRead(SDA) == LOW; i++)
+            {
+                lineLow(SCL);
+                delayMicroseconds(5);
+                lineRelease(SCL);
+                delayMicroseconds(5);
+            }
+
+            // STOP: SCL HIGH 상태에서 SDA LOW → HIGH
+            lineLow(SDA);
+            delayMicroseconds(5);
+            lineRelease(SDA);
+            delayMicroseconds(5);
+        }
+
+        void startWire()
+        {
+            Wire.begin();
+            Wire.setWireTimeout(TIMEOUT_US, true);
+            _clock = 0;
+        }
+
+        bool initSensor()
+        {
+            useClock(SENSOR_CLOCK);
+            _sensorFails = 0;
+            if (!_sensor.isConnected() || !_sensor.configure()) return false; // 필터/아날로그 출력 설정
+            _sensorOk = true;
+            return true;
+        }
+
+        void recoverBus()
+        {
+            _recoveries++;
+            releaseBus();
+            startWire();
+
+            useClock(LCD_CLOCK);
+            _lcdOk = probe(_lcd.address());
+            if (_lcdOk) _lcd.init();
+            if (!initSensor()) sensorLost();
+
+            if (_lcdOk && !Wire.getWireTimeoutFlag())
+            {
+                _busFault = false;
+                return;
+            }
+
+            Wire.clearWireTimeoutFlag();
+            _recoveryFailures++;
+            _busRetryAtMs = millis() + _busBackoffMs;
+            _busBackoffMs = nextBackoff(_busBackoffMs);
+        }
+
+        void retrySensor()
+        {
+            if (initSensor()) return;
+            checkTimeout();
+            _sensorRetryAtMs = millis() + _sensorBackoffMs;
+            _sensorBackoffMs = nextBackoff(_sensorBackoffMs);
+        }
+
+    public:
+        I2cBus(AngleSource& angle, As5600Lean& sensor, ShadowLcd& lcd, uint16_t sensorPeriodUs)
+            : _angle(angle), _sensor(sensor), _lcd(lcd)
+        {
+            _periodUs = sensorPeriodUs;
+            _nextDue = 0;
+            _lcdCharUs = 0;
+            _lcdWaitPeriods = 0;
+            _lcdFlushes = 0;
+            _clock = 0;
+            _sensorOk = false;
+            _lcdOk = true;
+            _busFault = false;
+            _sensorFails = 0;
+            _busBackoffMs = BACKOFF_MIN_MS;
+            _busRetryAtMs = 0;
+            _sensorBackoffMs = BACKOFF_MIN_MS;
+            _sensorRetryAtMs = 0;
+            _lastProbeMs = 0;
+            _timeouts = 0;
+            _recoveries = 0;
+            _recoveryFailures = 0;
+            resetStats();
+        }
+
+    // Wire 시작 + 타임아웃 설정 (lcd.init() 보다 먼저)
+    void begin()
+    {
+        startWire();
+    }
+
+    // setup에서 AS5600 확인. 없으면 false (포토 전용 모드)
+    bool beginSensor()
+    {
+        if (!initSensor()) sensorLost();
+        return _sensorOk;
+    }
+
+    bool sensorAvailable() const { return _sensorOk; }
+    uint32_t lcdFlushes() const { return _lcdFlushes; }
+
+    void resetStats()
+    {
+        for (uint8_t i = 0; i < HIST_BUCKETS; i++) _hist[i] = 0;
+        _maxWaitUs = 0;
+    }
+
+    // loop에서 최대한 자주 호출
+    void service()
+    {
+        if (_busFault)
+        {
+            if ((int32_t)(millis() - _busRetryAtMs) >= 0) recoverBus();
+            return;
+        }
+        if (!_sensorOk && (int32_t)(millis() - _sensorRetryAtMs) >= 0)
+        {
+            retrySensor();
+            return;
+        }
+
+        bool sensorOnBus = _sensorOk && _angle.kind() == AngleSource::SRC_I2C;
+        uint32_t now = micros();
+
+        if (sensorOnBus && (int32_t)(now - _nextDue) >= 0)
+        {
+            record(now - _nextDue);
+            useClock(SENSOR_CLOCK);
+            bool ok = _angle.poll();
+            if (checkTimeout()) return;
+            if (ok) _sensorFails = 0;
+            else if (++_sensorFails >= SENSOR_FAIL_LIMIT) { sensorLost(); return; }
+            _nextDue += _periodUs;
+            if ((int32_t)(micros() - _nextDue) > (int32_t)_periodUs) _nextDue = micros(); // 많이 밀렸으면 재동기
+            if (_lcd.isDirty() && _lcdWaitPeriods < 0xFF) _lcdWaitPeriods++;
+            return;
+        }
+
+        if (_sensorOk && !sensorOnBus && millis() - _lastProbeMs >= HEALTH_PROBE_MS)
+        {
+            _lastProbeMs = millis();
+            useClock(SENSOR_CLOCK);
+            if (_sensor.checkStatus()) _sensorFails = 0;
+            else if (++_sensorFails >= SENSOR_FAIL_LIMIT) sensorLost();
+            checkTimeout();
+            return;
+        }
+
+        if (!_lcd.isDirty()) return;
+        // 센서 차례 전까지 못 끝내면 미룸. 100kHz에서 한 글자(~1.5ms)가 1ms 주기보다 길 수 있으므로
+        // LCD_STARVE_PERIODS 주기 동안 못 보냈으면 센서 읽기 바로 뒤에 한 글자 보냄 (다음 샘플이 그만큼 늦음, 히스토그램에 남음)
+        if (sensorOnBus && (int32_t)(_nextDue - now) < (int32_t)_lcdCharUs
+            && _lcdWaitPeriods < LCD_STARVE_PERIODS) return;
+
+        useClock(LCD_CLOCK);
+        uint32_t t0 = micros();
+        _lcd.flushStep();
+        if (checkTimeout()) return;
+        uint16_t took = (uint16_t)(micros() - t0);
+        _lcdCharUs = _lcdCharUs ? _lcdCharUs - (_lcdCharUs >> 3) + (took >> 3) : took; // 첫 값은 그대로
+        _lcdWaitPeriods = 0;
+        _lcdFlushes++;
+    }
+
+    // delay() 대신: 기다리는 동안에도 센서 읽기/LCD 갱신을 계속함
+    void wait(unsigned long ms)
+    {
+        unsigned long start = millis();
+        while (millis() - start < ms) service();
+    }
+
+    void printStats(Print& out) const
+    {
+        out.print(F("i2c_wait_hist_us"));
+        for (uint8_t i = 0; i < HIST_BUCKETS; i++)
+        {
+            out.print(i == 0 ? ',' : ' ');
+            out.print(_hist[i]);
+        }
+        out.println();
+        out.print(F("i2c_wait_max_us,")); out.println(_maxWaitUs);
+        out.print(F("lcd_char_us,"));     out.println(_lcdCharUs);
+        out.print(F("lcd_flushes,"));     out.println(_lcdFlushes);
+        out.print(F("i2c_timeouts,"));    out.println(_timeouts);
+        out.print(F("i2c_recoveries,"));  out.println(_recoveries);
+        out.print(F("i2c_recovery_failures,")); out.println(_recoveryFailures);
+        out.print(F("sensor_ok,"));       out.println(_sensorOk ? 1 : 0);
+        out.print(F("magnet_status,"));   out.println(_sensor.status(), HEX);
+        out.print(F("magnet_agc,"));      out.println(_sensor.agc());
+    }
+};
+
+extern I2cBus bus;
@@ -0,0 +1,99 @@
+#pragma once
+#include <Arduino.h>
+
+// ==================== loop() 시간 계측 ====================
+// loop() 맨 앞에서 mark()를 부르면 직전 패스(이전 mark ~ 지금) 시간을 그 패스의 슬롯에 누적.
+// 슬롯 = (모드, 스텝) 하나. 슬롯별 최소/평균/최대(us)와 마감 초과 횟수를 모음.
+// 최소/최대는 16비트라 65535us 넘는 패스(예: bus.wait(1000))는 65535로 포화.
+// -DLOOP_STATS 빌드([env:uno_stats])에서만 켜짐. 꺼져 있으면 빈 인라인 함수라 코드/RAM 0.
+#ifdef LOOP_STATS
+template <uint8_t Slots>
+class LoopStats
+{
+    private:
+        struct Slot
+        {
+            uint8_t mode;
+            uint8_t step;
+            uint16_t count;
+            uint16_t missed;
+            uint16_t minUs;
+            uint16_t maxUs;
+            uint32_t sumUs;
+        };
+
+        Slot _slots[Slots];
+        uint8_t _cur;          // 진행 중인 패스의 슬롯
+        uint32_t _deadlineUs;  // 진행 중인 패스의 마감
+        uint32_t _startUs;
+
+    public:
+        LoopStats()
+        {
+            reset();
+            _cur = 0xFF;
+        }
+
+    void reset()
+    {
+        for (uint8_t i = 0; i < Slots; i++)
+        {
+            _slots[i].count = 0;
+            _slots[i].missed = 0;
+        }
+    }
+
+    // loop() 맨 앞에서 호출 (slot = 이번 패스의 슬롯, deadlineUs = 이번 패스가 넘으면 안 되는 시간)
+    void mark(uint8_t slot, uint8_t mode, uint8_t step, uint32_t deadlineUs)
+    {
+        uint32_t now = micros();
+        if (_cur < Slots)
+        {
+            uint32_t dt = now - _startUs;
+            uint16_t dt16 = dt > 0xFFFF ? 0xFFFF : (uint16_t)dt;
+            Slot& s = _slots[_cur];
+            if (s.count == 0xFFFF || s.sumUs > 0xFFFFFFFFUL - dt) { s.count >>= 1; s.sumUs >>= 1; } // 넘침 전에 반으로
+            if (s.count == 0 || dt16 < s.minUs) s.minUs = dt16;
+            if (s.count == 0 || dt16 > s.maxUs) s.maxUs = dt16;
+            s.count++;
+            s.sumUs += dt;
+            if (dt > _deadlineUs && s.missed < 0xFFFF) s.missed++;
+        }
+
+        if (slot < Slots)
+        {
+            Slot& s = _slots[slot];
+            if (s.count == 0) { s.sumUs = 0; s.mode = mode; s.step = step; }
+        }
+        _cur = slot;
+        _deadlineUs = deadlineUs;
+        _startUs = now;
+    }
+
+    // "loop,<mode>,<step>,<n>,<min_us>,<avg_us>,<max_us>,<missed>" (쓰인 슬롯만)
+    void print(Print& out) const
+    {
+        for (uint8_t i = 0; i < Slots; i++)
+        {
+            const Slot& s = _slots[i];
+            if (s.count == 0) continue;
+            out.print(F("loop,"));  out.print(s.mode);
+            out.print(',');         out.print(s.step);
+            out.print(',');         out.print(s.count);
+            out.print(',');         out.print(s.minUs);
+            out.print(',');         out.print(s.sumUs / s.count);
+            out.print(',');         out.print(s.maxUs);
+            out.print(',');         out.println(s.missed);
+        }
+    }
+};
+#else
+template <uint8_t Slots>
+class LoopStats
+{
+    public:
+    void reset() {}
+    void mark(uint8_t, uint8_t, uint8_t, uint32_t) {}
+    void print(Print& out) const { out.println(F("loop stats off (build with -DLOOP_STATS)")); }
+};
+#endif
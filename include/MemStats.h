@@ -0,0 +1,14 @@
+#pragma once
+#include <Arduino.h>
+
+// ==================== RAM 사용량 / 스택 최고 수위 ====================
+// 부팅 직후(.init3, main() 전) 정적 변수 끝 ~ RAMEND를 0xC5로 칠해 두고,
+// 나중에 한 번도 덮어써지지 않은 칸을 세서 스택이 가장 깊이 내려갔던 지점을 구함.
+namespace memstats
+{
+    uint16_t staticBytes();   // .data + .bss
+    uint16_t freeNow();       // 지금 힙 끝 ~ SP
+    uint16_t stackPeak();     // 부팅 후 최대 스택 사용량 (RAMEND 기준)
+    uint16_t stackUnused();   // 한 번도 안 쓰인 바이트 = 최악일 때 남은 여유
+    void print(Print& out);
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <Arduino.h>
+#include "FastPin.h"
+
+// ==================== 여러 포토 게이트 동시 캡처 (한 포트, 핀 변화 인터럽트) ====================
+// 같은 포트에 있는 게이트 핀들을 PCINT 하나로 받음. ISR마다 포트를 한 번 읽고 직전 값과 비교해서
+//   fell = 직전 HIGH & 지금 LOW (빔 막힘)  → 비트마다 채널을 찾아 같은 micros() 시각을 붙임.
+// 채널마다 디바운스(마지막으로 받은 엣지 기준), 링 버퍼, 버린 엣지 수를 따로 가짐 → loop는 poll(ch)로 꺼냄.
+// 한 ISR에서 여러 채널이 함께 떨어지면 시각 하나를 공유 (micros() 한 번).
+// isrWith(port)는 포트 값을 받아서 처리 (isr()는 실제 포트를 읽어 넘김, 벤치마크는 값을 직접 넣음).
+template <uint8_t FirstPin, uint8_t... Pins>
+class MultiGateCapture
+{
+    public:
+        static constexpr uint8_t CHANNELS = 1 + sizeof...(Pins);
+        static constexpr uint8_t QUEUE_SIZE = 4; // 채널당, 2의 거듭제곱
+        static constexpr uint8_t PORT_ID = pinmap::port(FirstPin);
+
+    private:
+        static constexpr uint8_t MASK = pinmap::MaskOf<FirstPin, Pins...>::value;
+        typedef pinmap::Regs<PORT_ID> R;
+
+        static_assert(PORT_ID != pinmap::PORT_ID_NONE, "MultiGateCapture: invalid pin");
+        static_assert(pinmap::AllOnPort<PORT_ID, Pins...>::value, "MultiGateCapture: all pins must share one port");
+        static_assert(CHANNELS <= 8, "MultiGateCapture: at most 8 channels (one port)");
+
+        uint8_t _pinOf[CHANNELS];
+        uint8_t _chOfBit[8];
+
+        // ISR 전용 상태
+        uint8_t _prev;
+        uint32_t _debounceUs;
+        uint32_t _lastUs[CHANNELS];
+        uint8_t _seen; // 채널별 비트: 엣지를 한 번이라도 받았는지
+
+        // ISR → loop 큐 (채널마다 단일 생산자/소비자)
+        volatile uint8_t _head[CHANNELS];
+        volatile uint8_t _tail[CHANNELS];
+        volatile uint32_t _queue[CHANNELS][QUEUE_SIZE];
+        volatile uint8_t _dropped[CHANNELS];
+
+        void accept(uint8_t ch, uint32_t t)
+        {
+            uint8_t bit = (uint8_t)(1 << ch);
+            if ((_seen & bit) && t - _lastUs[ch] < _debounceUs) return;
+            _seen |= bit;
+            _lastUs[ch] = t;
+
+            uint8_t next = (_head[ch] + 1) & (QUEUE_SIZE - 1);
+            if (next == _tail[ch]) { _dropped[ch]++; return; }
+            _queue[ch][_head[ch]] = t;
+            _head[ch] = next;
+        }
+
+    public:
+        MultiGateCapture()
+        {
+            const uint8_t pins[CHANNELS] = { FirstPin, Pins... };
+            for (uint8_t b = 0; b < 8; b++) _chOfBit[b] = 0xFF;
+            for (uint8_t ch = 0; ch < CHANNELS; ch++)
+            {
+                _pinOf[ch] = pins[ch];
+                _chOfBit[pinmap::bit(pins[ch])] = ch;
+                _lastUs[ch] = 0;
+                _head[ch] = 0;
+                _tail[ch] = 0;
+                _dropped[ch] = 0;
+            }
+            _prev = 0xFF;
+            _debounceUs = 0;
+            _seen = 0;
+        }
+
+    // 핀 INPUT_PULLUP + 포트에 맞는 PCMSK 비트 + PCICR 그룹. 다시 부르면 큐/디바운스/버린 수도 처음부터
+    void begin(uint32_t debounceUs)
+    {
+        uint8_t sreg = SREG;
+        cli();
+        _debounceUs = debounceUs;
+        _seen = 0;
+        for (uint8_t ch = 0; ch < CHANNELS; ch++)
+        {
+            _head[ch] = 0;
+            _tail[ch] = 0;
+            _dropped[ch] = 0;
+        }
+        R::ddr() &= (uint8_t)~MASK;
+        R::out() |= MASK;
+        _prev = R::in();
+#ifdef __AVR__
+        switch (PORT_ID)
+        {
+            case pinmap::PORT_ID_B: PCMSK0 |= MASK; PCIFR = _BV(PCIF0); PCICR |= _BV(PCIE0); break;
+            case pinmap::PORT_ID_C: PCMSK1 |= MASK; PCIFR = _BV(PCIF1); PCICR |= _BV(PCIE1); break;
+            case pinmap::PORT_ID_D: PCMSK2 |= MASK; PCIFR = _BV(PCIF2); PCICR |= _BV(PCIE2); break;
+        }
+#endif
+        SREG = sreg;
+    }
+
+    // PCINTx_vect에서 호출
+    void isr() { isrWith(R::in()); }
+
+    void isrWith(uint8_t now)
+    {
+        uint8_t fell = _prev & (uint8_t)~now & MASK;
+        _prev = now;
+        if (!fell) return;
+        uint32_t t = micros();
+        for (uint8_t b = 0; fell; b++, fell >>= 1)
+            if (fell & 1) accept(_chOfBit[b], t);
+    }
+
+    // 채널 ch에 엣지가 있으면 시각을 꺼내고 true
+    bool poll(uint8_t ch, uint32_t& tUs)
+    {
+        if (_tail[ch] == _head[ch]) return false;
+        tUs = _queue[ch][_tail[ch]];
+        _tail[ch] = (_tail[ch] + 1) & (QUEUE_SIZE - 1);
+        return true;
+    }
+
+    uint8_t pin(uint8_t ch) const { return _pinOf[ch]; }
+    static constexpr uint8_t mask() { return MASK; }
+    uint8_t dropped(uint8_t ch) const { return _dropped[ch]; }
+};
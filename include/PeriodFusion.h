@@ -0,0 +1,73 @@
+#pragma once
+#include <Arduino.h>
+#include <math.h>
+
+// ==================== 두 센서 주기 교차 검증 ====================
+// SwingStats: 반주기 간격 이벤트 시각(us)을 차례로 받아 겹치지 않는 왕복 주기(이벤트 0→2, 2→4, ...)의
+//   평균과 표준오차를 점진적으로 쌓음. 이벤트를 저장하지 않으므로 RAM 20바이트 남짓.
+//   합은 첫 주기와의 차이(us)로 쌓아서 float(32비트)에서도 자릿수가 남게 함.
+// fusePeriods: 독립인 두 추정 (T1, s1), (T2, s2)를 역분산 가중으로 합침
+//   T = (T1/s1^2 + T2/s2^2) / (1/s1^2 + 1/s2^2),  s = 1 / sqrt(1/s1^2 + 1/s2^2)
+//   z = |T1 - T2| / sqrt(s1^2 + s2^2) 가 zLimit를 넘으면 두 센서가 불확도 이상으로 어긋난 것
+class SwingStats
+{
+    private:
+        uint32_t _t0;     // 지금 왕복 시작 이벤트
+        uint32_t _first;  // 첫 왕복 주기 (us)
+        uint8_t _events;  // 받은 이벤트 수
+        uint8_t _n;       // 왕복 수
+        float _sum, _sum2; // 주기 - 첫 주기 (us)
+
+    public:
+    void reset() { memset(this, 0, sizeof(*this)); }
+
+    void add(uint32_t tUs)
+    {
+        if (_events == 0) _t0 = tUs;
+        else if (_events % 2 == 0)
+        {
+            uint32_t period = tUs - _t0;
+            _t0 = tUs;
+            if (_n == 0) _first = period;
+            float d = (float)(int32_t)(period - _first);
+            _sum += d;
+            _sum2 += d * d;
+            _n++;
+        }
+        if (_events < 255) _events++;
+    }
+
+    uint8_t count() const { return _n; }
+
+    float meanUs() const { return _n > 0 ? _first + _sum / _n : 0.0; }
+
+    // 평균의 표준오차 (us). 왕복 2개 미만이면 0. 끝점 micros() 4us 양자화(균등 2개)를 더함
+    float semUs() const
+    {
+        if (_n < 2) return 0.0;
+        float var = (_sum2 - _sum * _sum / _n) / (_n - 1);
+        if (var < 0) var = 0;
+        float q = 4.0 / _n;
+        return sqrt(var / _n + q * q / 6.0);
+    }
+};
+
+struct FusedPeriod
+{
+    float T;        // 가중 평균 (s)
+    float sigma;    // 1 sigma (s)
+    float z;        // 두 추정 차이 / 합성 불확도
+    bool disagree;  // z > zLimit
+};
+
+inline FusedPeriod fusePeriods(float T1, float s1, float T2, float s2, float zLimit)
+{
+    FusedPeriod f;
+    float w1 = 1.0 / (s1 * s1);
+    float w2 = 1.0 / (s2 * s2);
+    f.T = (T1 * w1 + T2 * w2) / (w1 + w2);
+    f.sigma = 1.0 / sqrt(w1 + w2);
+    f.z = fabs(T1 - T2) / sqrt(s1 * s1 + s2 * s2);
+    f.disagree = f.z > zLimit;
+    return f;
+}
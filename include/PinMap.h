@@ -0,0 +1,81 @@
+#pragma once
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h> // [env:native] 시뮬레이션 포트 (test/test_fastpin)
+#endif
+
+// ==================== Uno(ATmega328P) 핀 → 포트/비트 ====================
+// D0~D7 = PORTD, D8~D13 = PORTB, A0~A5(14~19) = PORTC
+// 전부 constexpr 이라 템플릿 인자로 쓰면 컴파일 타임에 레지스터/비트가 결정됨
+namespace pinmap
+{
+    enum Port : uint8_t { PORT_ID_B, PORT_ID_C, PORT_ID_D, PORT_ID_NONE };
+
+    constexpr uint8_t port(uint8_t pin)
+    {
+        return pin < 8 ? PORT_ID_D : pin < 14 ? PORT_ID_B : pin < 20 ? PORT_ID_C : PORT_ID_NONE;
+    }
+
+    constexpr uint8_t bit(uint8_t pin)
+    {
+        return pin < 8 ? pin : pin < 14 ? pin - 8 : pin - 14;
+    }
+
+    constexpr uint8_t mask(uint8_t pin)
+    {
+        return (uint8_t)(1 << bit(pin));
+    }
+
+    // 포트 + 비트 → Arduino 핀 번호 (이벤트에 핀 번호를 실어 보내기 위함)
+    constexpr uint8_t pinOf(uint8_t portId, uint8_t b)
+    {
+        return portId == PORT_ID_D ? b : portId == PORT_ID_B ? 8 + b : 14 + b;
+    }
+
+    // 포트별 레지스터 (특수화 → 상수 주소라 in/out/sbi/cbi 명령 1개로 컴파일됨)
+    // AVR이 아닌 빌드(native)에서는 RAM 변수로 흉내낸 포트를 씀
+    template <uint8_t PortId> struct Regs;
+#ifdef __AVR__
+    template <> struct Regs<PORT_ID_B>
+    {
+        static inline volatile uint8_t& in()  { return PINB; }
+        static inline volatile uint8_t& out() { return PORTB; }
+        static inline volatile uint8_t& ddr() { return DDRB; }
+    };
+    template <> struct Regs<PORT_ID_C>
+    {
+        static inline volatile uint8_t& in()  { return PINC; }
+        static inline volatile uint8_t& out() { return PORTC; }
+        static inline volatile uint8_t& ddr() { return DDRC; }
+    };
+    template <> struct Regs<PORT_ID_D>
+    {
+        static inline volatile uint8_t& in()  { return PIND; }
+        static inline volatile uint8_t& out() { return PORTD; }
+        static inline volatile uint8_t& ddr() { return DDRD; }
+    };
+#else
+    template <uint8_t PortId> struct Regs
+    {
+        static inline volatile uint8_t& in()  { static volatile uint8_t r = 0xFF; return r; }
+        static inline volatile uint8_t& out() { static volatile uint8_t r = 0; return r; }
+        static inline volatile uint8_t& ddr() { static volatile uint8_t r = 0; return r; }
+    };
+#endif
+
+    // 가변 인자 핀 목록 → 비트마스크 / 같은 포트인지 검사
+    template <uint8_t... Pins> struct MaskOf;
+    template <> struct MaskOf<> { static constexpr uint8_t value = 0; };
+    template <uint8_t P, uint8_t... Rest> struct MaskOf<P, Rest...>
+    {
+        static constexpr uint8_t value = mask(P) | MaskOf<Rest...>::value;
+    };
+
+    template <uint8_t PortId, uint8_t... Pins> struct AllOnPort;
+    template <uint8_t PortId> struct AllOnPort<PortId> { static constexpr bool value = true; };
+    template <uint8_t PortId, uint8_t P, uint8_t... Rest> struct AllOnPort<PortId, P, Rest...>
+    {
+        static constexpr bool value = port(P) == PortId && AllOnPort<PortId, Rest...>::value;
+    };
+}
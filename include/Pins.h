@@ -0,0 +1,19 @@
+#pragma once
+#include <Arduino.h>
+#include "FastPin.h"
+
+// ==================== 핀 설정 ====================
+#define BUTTON_A_PIN 2
+#define BUTTON_B_PIN 3
+#define BUZZER_PIN 9
+#define POT_PIN A1
+#define AS5600_OUT_PIN A0 // [추가] AS5600 OUT (아날로그 출력) → 고속 ADC 각도 경로 (-DANGLE_SOURCE_ANALOG 또는 Serial 'A')
+#define PHOTO_PIN 5       // [추가] 포토 인터럽터 핀 (기존 4번은 AS5600 충돌 가능성으로 5번 권장)
+
+// [추가] 다중 게이트 빌드(-DMULTI_GATE) 채널 핀: 포트 D에서 Serial(D0/D1)을 뺀 6개 (PCINT18~23)
+// 게이트 전용 보드라 버튼/AS5600 방향 핀 자리를 게이트 입력으로 씀
+#define GATE_RIG_PINS 2, 3, 4, 5, 6, 7
+
+// 측정 루프 등 핫패스용 직접 포트 접근 (digitalRead/digitalWrite 대신)
+typedef FastPin<PHOTO_PIN>  PhotoPin;
+typedef FastPin<BUZZER_PIN> BuzzerPin;
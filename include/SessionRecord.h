@@ -0,0 +1,99 @@
+#pragma once
+#include <Arduino.h>
+
+// ==================== 세션 기록 / 재생 ====================
+// loop() 한 패스가 보는 입력(시계, 각도, 팟, 포토, 버튼, 센서/자석 상태, 게이트 엣지)을 PassInputs 하나로 묶음.
+// 상태 머신은 패스 동안 이 스냅샷만 보므로 같은 스냅샷을 같은 순서로 넣으면 같은 결과가 나옴.
+// 기록: 시계를 뺀 입력이 바뀌었거나 단계(모드, 스텝, 카운트다운, 측정 로그 수)가 바뀐 패스만 Serial에 냄.
+//   첫 줄만 절대값 "r,<us>,<ms>,<angle>,<pot>,<flags>[,<gateUs>]" (gateUs는 IN_GATE일 때만),
+//   그 뒤는 직전 기록 줄과의 차이 "d,<us 차>,<ms 차>,<angle>,<pot>,<flags>[,<gateUs - us>]"
+//   (angle/pot/flags는 직전과 같으면 빈 칸, 끝의 빈 칸은 생략) → 보통 패스 한 줄이 32바이트 → 17바이트 정도.
+//   두 줄 모두 끝에 패스를 마친 뒤 상태 지문 "*<CRC16 16진>"을 붙임 (+5바이트). 재생은 패스마다 이것과 비교
+//   → 결과 줄이 같아도 중간에 상태가 갈라진 패스를 바로 찾음.
+//   시각과 필터/타임스탬프 상태는 바꿈 판단에 넣지 않음 (넣으면 측정 중 거의 모든 패스가 기록되어
+//   TX 버퍼가 차고 Serial.print가 패스를 막음). 시간으로 일어나는 전환(버티기, 카운트다운)은 단계가 바뀌므로 남음.
+// 재생: [env:native_replay] 호스트 프로그램이 같은 상태 머신(src/StateMachine.cpp)에 기록을 넣음 (tools/replay_native.py).
+//   보드에서 확인할 때만 [env:uno_replay] (-DREPLAY): Serial로 들어온 r/d 줄을 한 패스씩 넣고
+//   줄마다 "ack"를 돌려줌 (호스트는 ack를 받고 다음 줄을 보냄 → 64바이트 수신 버퍼 넘침 없음).
+enum PassFlag : uint8_t
+{
+    IN_A      = 0x01, // A 눌림 (이번 패스)
+    IN_B      = 0x02, // B 눌림 (이번 패스)
+    IN_PHOTO  = 0x04, // 포토 핀 HIGH
+    IN_SENSOR = 0x08, // AS5600 사용 가능
+    IN_MAGNET = 0x10, // 자석 상태 정상
+    IN_GATE   = 0x20  // [추가] 포토 게이트 엣지 (인터럽트 캡처, 시각 = gateUs)
+};
+
+struct PassInputs
+{
+    uint32_t us;    // 패스 시작 micros()
+    uint32_t ms;    // 패스 시작 millis()
+    uint16_t angle; // angleSource.latest()
+    uint16_t pot;   // 팟 필터값
+    uint8_t flags;  // PassFlag
+    uint32_t gateUs; // [추가] IN_GATE일 때 빔이 막힌 micros()
+};
+
+namespace session
+{
+    // 시계를 뺀 입력이 바뀌었는지 (버튼/게이트 엣지는 이벤트라 있으면 항상 바뀐 것으로)
+    bool inputsChanged(const PassInputs& prev, const PassInputs& cur);
+
+    uint16_t crc16(const void* data, uint16_t n, uint16_t crc = 0xFFFF);
+
+    // 상태 지문: 필드를 고정 폭으로 하나씩 넣음 (int가 16비트인 보드와 32비트인 호스트에서
+    // 구조체 배치/패딩이 달라도 같은 값이 나옴, 둘 다 리틀 엔디언)
+    class StateHash
+    {
+        private:
+            uint16_t _crc;
+
+            void add(const void* p, uint8_t n) { _crc = crc16(p, n, _crc); }
+
+        public:
+            StateHash() { _crc = 0xFFFF; }
+
+        void u8(uint8_t v)   { add(&v, 1); }
+        void i16(int16_t v)  { add(&v, 2); }
+        void u16(uint16_t v) { add(&v, 2); }
+        void u32(uint32_t v) { add(&v, 4); }
+        void f32(float v)    { static_assert(sizeof(float) == 4, "StateHash: float must be 32-bit"); add(&v, 4); }
+        uint16_t value() const { return _crc; }
+    };
+
+    void printRecord(Print& out, const PassInputs& in, uint16_t hash);
+    bool parseRecord(const char* line, PassInputs& in); // "r,..." 줄이 아니면 false
+
+    // 직전 기록(prev) 대비 차이 줄
+    void printDelta(Print& out, const PassInputs& prev, const PassInputs& in, uint16_t hash);
+    bool parseDelta(const char* line, PassInputs& in); // in = 직전 기록 → 이번 패스. "d,..." 줄이 아니면 false (in 그대로)
+
+    // r/d 줄 끝의 상태 지문 "*<16진>". 없으면 false (지문을 넣기 전 기록)
+    bool parseHash(const char* line, uint16_t& hash);
+
+    // Serial 줄 단위 읽기 (막지 않음). 줄이 완성되면 포인터, 아니면 nullptr
+    class LineReader
+    {
+        private:
+            char _buf[56]; // 가장 긴 r 줄 (48) + 지문 (5)
+            uint8_t _len;
+            bool _overflow; // 너무 긴 줄은 통째로 버림
+
+        public:
+            LineReader()
+            {
+                _len = 0;
+                _overflow = false;
+            }
+
+        const char* poll(Stream& in);
+
+        // 쓰던 줄을 버림 (다음 글자부터 새 줄)
+        void reset()
+        {
+            _len = 0;
+            _overflow = false;
+        }
+    };
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include <Arduino.h>
+#ifdef ARDUINO
+#include <LiquidCrystal_I2C.h>
+#endif
+
+// ==================== LCD 섀도 버퍼 ====================
+// lcd.print/clear/setCursor는 RAM의 16x2 버퍼만 바꾸고 즉시 리턴.
+// 실제 I2C 전송은 flushStep()이 바뀐 칸만 한 글자씩 보냄 → I2cBus가 센서 읽기 사이에 끼워 넣음.
+// 같은 내용을 매 루프 다시 print 해도 버스 트래픽이 생기지 않음.
+// 재생 호스트([env:native_replay])에서는 LCD 없이 버퍼만 (init/backlight/flush 없음).
+class ShadowLcd : public Print
+{
+    public:
+        static constexpr uint8_t COLS = 16;
+        static constexpr uint8_t ROWS = 2;
+
+    private:
+#ifdef ARDUINO
+        LiquidCrystal_I2C _hw;
+#endif
+        uint8_t _addr;
+        char _cells[ROWS][COLS];
+        uint8_t _dirty[ROWS][(COLS + 7) / 8];
+        uint8_t _col, _row;       // 섀도 커서
+        uint8_t _hwCol, _hwRow;   // 실제 LCD 커서 (0xFF = 모름)
+
+        void markDirty(uint8_t r, uint8_t c) { _dirty[r][c >> 3] |= (uint8_t)(1 << (c & 7)); }
+        bool isDirty(uint8_t r, uint8_t c) const { return _dirty[r][c >> 3] & (1 << (c & 7)); }
+
+    public:
+#ifdef ARDUINO
+        ShadowLcd(uint8_t addr, uint8_t cols, uint8_t rows) : _hw(addr, cols, rows)
+#else
+        ShadowLcd(uint8_t addr, uint8_t, uint8_t)
+#endif
+        {
+            _addr = addr;
+            memset(_cells, ' ', sizeof(_cells));
+            memset(_dirty, 0, sizeof(_dirty));
+            _col = 0;
+            _row = 0;
+            _hwCol = 0xFF;
+            _hwRow = 0xFF;
+        }
+
+    uint8_t address() const { return _addr; }
+
+    void clear()
+    {
+        for (uint8_t r = 0; r < ROWS; r++)
+            for (uint8_t c = 0; c < COLS; c++)
+                if (_cells[r][c] != ' ') { _cells[r][c] = ' '; markDirty(r, c); }
+        _col = 0;
+        _row = 0;
+    }
+
+    void setCursor(uint8_t col, uint8_t row)
+    {
+        _col = col;
+        _row = row < ROWS ? row : ROWS - 1;
+    }
+
+    size_t write(uint8_t ch) override
+    {
+        if (_col < COLS)
+        {
+            if (_cells[_row][_col] != (char)ch) { _cells[_row][_col] = ch; markDirty(_row, _col); }
+        }
+        if (_col < 0xFF) _col++;
+        return 1;
+    }
+    using Print::write;
+
+    bool isDirty() const
+    {
+        for (uint8_t i = 0; i < sizeof(_dirty); i++) if (((const uint8_t*)_dirty)[i]) return true;
+        return false;
+    }
+
+    // 섀도 화면 한 칸 (재생 호스트가 화면을 찍어 볼 때)
+    char cell(uint8_t row, uint8_t col) const { return _cells[row][col]; }
+
+#ifdef ARDUINO
+    void init()
+    {
+        _hw.init();
+        _hwCol = 0xFF;
+        memset(_dirty, 0xFF, sizeof(_dirty)); // 실제 화면과 섀도를 다시 맞춤
+    }
+
+    void backlight() { _hw.backlight(); }
+
+    // 바뀐 칸 하나를 LCD로 보냄 (커서가 이어지면 setCursor 생략). 보낼 게 없으면 false
+    bool flushStep()
+    {
+        for (uint8_t r = 0; r < ROWS; r++)
+        {
+            for (uint8_t c = 0; c < COLS; c++)
+            {
+                if (!isDirty(r, c)) continue;
+                if (_hwRow != r || _hwCol != c) _hw.setCursor(c, r);
+                _hw.write(_cells[r][c]);
+                _dirty[r][c >> 3] &= (uint8_t)~(1 << (c & 7));
+                _hwRow = r;
+                _hwCol = c + 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 전부 바로 보냄 (setup 에러 화면처럼 스케줄러가 안 도는 곳에서만)
+    void flushAll() { while (flushStep()) { } }
+#endif
+};
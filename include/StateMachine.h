@@ -0,0 +1,105 @@
+#pragma once
+#include <Arduino.h>
+#include "SessionRecord.h"
+#include "EventLog.h"
+#include "DecayEstimator.h"
+#include "PeriodFusion.h"
+#include "FreqTracker.h"
+#include "ClockCal.h"
+#include "ShadowLcd.h"
+#include "HysteresisQuantizer.h"
+
+// ==================== 측정 상태 머신 (모드 0~6) ====================
+// loop() 한 패스의 판단/화면/결과 줄. 입력은 passIn 스냅샷만 보고 시계/핀/센서는 직접 읽지 않음.
+// 보드(main.cpp)와 재생 호스트(ReplayHost.cpp, [env:native_replay])가 src/StateMachine.cpp를 그대로 같이 컴파일함.
+// 출력: lcd (섀도 버퍼), buzzer 큐, Serial 결과 줄 (swing/amp_corr/decay/fuse/result)
+// 모드 상태의 시각 필드는 uint32_t: 보드(unsigned long = 32비트)와 호스트에서 넘침까지 같게 계산.
+
+// ==================== 모드별 상태 (공용 메모리) ====================
+// 한 번에 한 모드만 돌기 때문에 모드별 작업 변수를 union 하나에 겹쳐 둠.
+// 모드에 들어갈 때 enterMode()가 0으로 지우고 초기값을 넣음.
+struct Mode0State
+{
+    HysteresisQuantizer angleQ;
+    int shownTenths;
+};
+
+struct Mode1State
+{
+    int selection; // 0: Hall, 1: Photo, 2: Both (Hall+Photo)
+};
+
+struct Mode2State
+{
+    int step;
+    uint32_t stableStartTime;
+    float lastStableValue;
+};
+
+struct Mode3State
+{
+    int step;
+    uint32_t stableStartTime;
+    uint32_t timerStart;
+    uint32_t prevTime;
+    int countdown;
+
+    int hitCount;
+    int lastPhotoState;
+    uint32_t lastHitMs;
+    float peakAmp;       // 통과 사이 최대 각도 (AS5600이 있을 때, 피크 진폭)
+};
+
+struct Mode4State
+{
+    int editingStep;
+    int digits[6];
+    int currentDigitPosition;
+    int lastMappedDigit;
+    bool isInputDone;
+    HysteresisQuantizer digitQ;
+};
+
+struct Mode5State
+{
+    int step;
+    uint32_t stableStartTime;
+    uint32_t timerStart;
+    uint32_t prevTime;
+    int countdown;
+
+    int swingCount;
+    int prevIntAngle;
+    bool readyForPeak;
+    float filteredAbsAngle;
+    float peakAmp;       // 이번 반주기 최대 각도 (피크 진폭)
+};
+
+union ModeState
+{
+    Mode0State m0;
+    Mode1State m1;
+    Mode2State m2;
+    Mode3State m3;
+    Mode4State m4;
+    Mode5State m5;
+};
+
+extern int mode;
+extern ModeState modeState;
+extern float angleOffset;             // Mode 2에서 잡은 0점 (deg)
+extern PassInputs passIn;             // 이번 패스 입력 (runPass 전에 채움)
+extern FreqTracker<> freqTracker;     // 각도 스트림 주기 (표시만, 패스 입력 밖)
+extern ClockCal clockCal;
+
+void enterMode(int newMode, int step = 0); // 모드 전환: 상태 초기화 + 화면 갱신
+void resetSession();                       // 세션 시작 상태 (기록 시작 / 재생 시작)
+int currentStep();                         // 현재 모드의 진행 단계 (스텝이 없는 모드는 0)
+uint16_t stateCrc();                       // 상태 지문 (기록 줄의 "*<crc>", 재생 비교)
+void runPass();                            // passIn으로 한 패스
+
+// 쓰는 쪽(main.cpp / ReplayHost.cpp)이 정의
+extern ShadowLcd lcd;
+void holdMs(unsigned long ms); // 화면을 보여주려고 기다림 (재생은 안 기다림)
+void resetFrequency();         // Mode 5 측정 시작: 주기 추적기 초기화
+void printTrack();             // Mode 5 측정 끝: 스트림 주기 결과 줄
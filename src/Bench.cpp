@@ -0,0 +1,375 @@
+#ifdef BENCH
+#include <Arduino.h>
+#include "Bench.h"
+#include "Pins.h"
+#include "Buzzer.h"
+#include "AngleSource.h"
+#include "I2cBus.h"
+#include "EventLog.h"
+#include "ShadowLcd.h"
+#include "FreqTracker.h"
+#include "MultiGate.h"
+#include <AS5600.h>
+
+#define BENCH_WINDOW_US 100000UL  // 항목당 측정 시간 (100ms)
+
+static void report(const __FlashStringHelper* name, const __FlashStringHelper* unit, unsigned long value)
+{
+  Serial.print(F("bench,")); Serial.print(name);
+  Serial.print(','); Serial.print(unit);
+  Serial.print(','); Serial.println(value);
+}
+
+// Mode 3 step 2 폴링 루프와 같은 모양 (읽기 → 하강 엣지 비교)
+static unsigned long pollRate_digitalRead()
+{
+  volatile unsigned long edges = 0;
+  unsigned long loops = 0;
+  int last = digitalRead(PHOTO_PIN);
+  unsigned long start = micros();
+  while (micros() - start < BENCH_WINDOW_US)
+  {
+    for (uint8_t i = 0; i < 32; i++)
+    {
+      int s = digitalRead(PHOTO_PIN);
+      if (last == HIGH && s == LOW) edges++;
+      last = s;
+    }
+    loops += 32;
+  }
+  return loops * (1000000UL / BENCH_WINDOW_US);
+}
+
+static unsigned long pollRate_fastPin()
+{
+  volatile unsigned long edges = 0;
+  unsigned long loops = 0;
+  bool last = PhotoPin::read();
+  unsigned long start = micros();
+  while (micros() - start < BENCH_WINDOW_US)
+  {
+    for (uint8_t i = 0; i < 32; i++)
+    {
+      bool s = PhotoPin::read();
+      if (last && !s) edges++;
+      last = s;
+    }
+    loops += 32;
+  }
+  return loops * (1000000UL / BENCH_WINDOW_US);
+}
+
+// 빈 루프 처리량 → 인터럽트가 빼앗은 CPU 비율 측정용
+static unsigned long spinRate()
+{
+  unsigned long loops = 0;
+  unsigned long start = micros();
+  while (micros() - start < BENCH_WINDOW_US) loops++;
+  return loops;
+}
+
+static unsigned long loadPermille(unsigned long base, unsigned long rate)
+{
+  return rate >= base ? 0 : (base - rate) * 1000UL / base;
+}
+
+// 부저 ISR 부하: 틱 없음(기준) / 시퀀서 재생 중 / 기존 tone() 재생 중
+static void buzzerLoad()
+{
+  TIMSK0 &= ~_BV(OCIE0B);
+  unsigned long base = spinRate();
+
+  tone(BUZZER_PIN, 1200);
+  unsigned long toneRate = spinRate();
+  noTone(BUZZER_PIN);
+  buzzer.begin();
+
+  TIMSK0 |= _BV(OCIE0B);
+  buzzer.play(1200, 300);
+  delay(5);
+  unsigned long seqRate = spinRate();
+  while (!buzzer.isIdle()) { }
+
+  report(F("isr_load_tone_1200Hz"), F("permille"), loadPermille(base, toneRate));
+  report(F("isr_load_sequencer_1200Hz"), F("permille"), loadPermille(base, seqRate));
+}
+
+// 각도 경로 비교: 100ms 동안 스트림에서 꺼낸 샘플 수와 샘플 간격 분포
+static void anglePath(AngleSource::Kind kind, const __FlashStringHelper* rateName, const __FlashStringHelper* jitterName)
+{
+  AngleSource::Kind saved = angleSource.kind();
+  selectAngleSource(kind);
+  Wire.setClock(I2cBus::SENSOR_CLOCK);
+
+  AngleSample s;
+  unsigned long count = 0;
+  unsigned long prevT = 0;
+  unsigned long minDt = 0xFFFFFFFFUL, maxDt = 0;
+  unsigned long start = micros();
+  while (micros() - start < BENCH_WINDOW_US)
+  {
+    angleSource.poll();
+    while (angleSource.pop(s))
+    {
+      if (count > 0)
+      {
+        unsigned long dt = s.tUs - prevT;
+        if (dt < minDt) minDt = dt;
+        if (dt > maxDt) maxDt = dt;
+      }
+      prevT = s.tUs;
+      count++;
+    }
+  }
+  selectAngleSource(saved);
+
+  report(rateName, F("samples_per_s"), count * (1000000UL / BENCH_WINDOW_US));
+  report(jitterName, F("us_max_minus_min"), count > 1 ? maxDt - minDt : 0);
+}
+
+// AS5600 읽기 1회 비용: 라이브러리 readAngle() vs 파킹된 2바이트 읽기 (400kHz)
+static void as5600ReadCost()
+{
+  const uint16_t N = 200;
+  AS5600 lib(&Wire);
+  As5600Lean lean(Wire);
+  Wire.setClock(I2cBus::SENSOR_CLOCK);
+
+  volatile uint16_t sink = 0;
+  unsigned long t0 = micros();
+  for (uint16_t i = 0; i < N; i++) sink = lib.readAngle();
+  unsigned long libUs = micros() - t0;
+
+  uint16_t raw;
+  lean.configure();
+  t0 = micros();
+  for (uint16_t i = 0; i < N; i++) { lean.readAngle(raw); sink = raw; }
+  unsigned long leanUs = micros() - t0;
+  (void)sink;
+
+  report(F("as5600_read_library"), F("us_per_read"), libUs / N);
+  report(F("as5600_read_lean"),    F("us_per_read"), leanUs / N);
+}
+
+// 측정 로그 왕복 확인: 반주기 ~0.5s + 지터로 가득 채운 뒤 같은 시퀀스와 비교
+// (setup() 중이라 runLog는 아직 비어 있음, 끝나면 다시 비움)
+static uint32_t synthHalfPeriod(uint16_t& seed, uint16_t i)
+{
+  seed = seed * 25173U + 13849U;                          // 16비트 LCG
+  uint32_t base = (i & 1) ? 480000UL : 520000UL;          // 게이트가 중심에서 벗어난 경우
+  return (base + (seed >> 7) - 256) & ~3UL;               // ±256us 지터, micros() 해상도
+}
+
+static void eventLogRoundTrip()
+{
+  runLog.clear();
+  uint16_t seed = 1;
+  uint32_t t = 0xFFF00000UL; // micros() 넘침 구간 포함
+  unsigned long t0 = micros();
+  while (runLog.append(t)) t += synthHalfPeriod(seed, runLog.count());
+  unsigned long encUs = micros() - t0;
+
+  seed = 1;
+  t = 0xFFF00000UL;
+  unsigned long errors = 0;
+  uint32_t v;
+  RunLog::Reader r(runLog);
+  t0 = micros();
+  for (uint16_t i = 0; r.next(v); i++)
+  {
+    if (v != t) errors++;
+    t += synthHalfPeriod(seed, i + 1);
+  }
+  unsigned long decUs = micros() - t0;
+
+  uint16_t n = runLog.count();
+  report(F("eventlog_events"),        F("count"),           n);
+  report(F("eventlog_density"),       F("bytes_per_100ev"), runLog.bytesUsed() * 100UL / n);
+  report(F("eventlog_roundtrip_err"), F("count"),           errors);
+  report(F("eventlog_append"),        F("us_per_event"),    encUs / n);
+  report(F("eventlog_decode"),        F("us_per_event"),    decUs / n);
+  runLog.clear();
+}
+
+// ==================== 사이클 카운트 ====================
+// 부저가 쉬는 동안 Timer1을 clk/1 자유 카운터로 빌려서 코드 구간의 CPU 사이클을 셈 (최대 65535).
+// 순수 계산 구간은 인터럽트를 막고 1회, I2C 구간은 인터럽트가 필요하므로 N회 중 최솟값.
+// 빈 구간 측정값(오버헤드)을 빼서 보고.
+extern ShadowLcd lcd;
+
+static uint16_t cycOverhead;
+
+static inline void cycStart() { TCNT1 = 0; }
+static inline uint16_t cycStop() { uint16_t c = TCNT1; return c > cycOverhead ? c - cycOverhead : 0; }
+
+// 포토 엣지 → 타임스탬프: Mode 3 step 2에서 통과 한 번에 하는 일 (핀 읽기, 엣지 비교, micros(), 로그 추가)
+static uint16_t cycEdgeCapture()
+{
+  runLog.clear();
+  runLog.append(micros());
+  bool last = !PhotoPin::read(); // 이번 읽기가 엣지가 되도록
+  uint8_t sreg = SREG;
+  cli();
+  cycStart();
+  bool s = PhotoPin::read();
+  if (last != s) runLog.append(micros());
+  uint16_t c = cycStop();
+  SREG = sreg;
+  runLog.clear();
+  return c;
+}
+
+static uint16_t cycAs5600Read()
+{
+  As5600Lean lean(Wire);
+  Wire.setClock(I2cBus::SENSOR_CLOCK);
+  lean.configure();
+  uint16_t raw, best = 0xFFFF;
+  for (uint8_t i = 0; i < 32; i++)
+  {
+    cycStart();
+    lean.readAngle(raw);
+    uint16_t c = cycStop();
+    if (c < best) best = c;
+  }
+  return best;
+}
+
+static uint16_t cycLcdChar()
+{
+  Wire.setClock(I2cBus::LCD_CLOCK);
+  uint16_t best = 0xFFFF;
+  for (uint8_t i = 0; i < 8; i++)
+  {
+    lcd.setCursor(15, 1);
+    lcd.write(i & 1 ? '*' : ' ');
+    cycStart();
+    lcd.flushStep();
+    uint16_t c = cycStop();
+    if (c < best) best = c;
+  }
+  lcd.flushAll();
+  return best;
+}
+
+// 주기 추적기: 칸 안 샘플 1개 (모든 샘플) / 칸을 닫는 샘플 1개 (20Hz, 누적 + sqrt/acos)
+// 2초 분량 정현파(1kHz, 진폭 10도, 주기 1.6s)로 이력과 누적을 채운 뒤 잼
+static FreqTracker<> benchTracker;
+
+static void cycFreqTracker(uint16_t& sample, uint16_t& bin)
+{
+  benchTracker.reset();
+  uint32_t t = 0;
+  for (uint16_t i = 0; i < 2000; i++, t += 1000)
+    benchTracker.push(t, (int16_t)(114.0 * cos(2.0 * M_PI * t / 1600000.0)));
+
+  benchTracker.push(t, 57); // 여기서 칸 하나 닫힘 (t = 2000000, 칸 경계)
+
+  uint8_t sreg = SREG;
+  cli();
+  cycStart();
+  benchTracker.push(t + 100, 57); // 같은 칸
+  sample = cycStop();
+  cycStart();
+  benchTracker.push(t + 50000, 57); // 칸 닫힘
+  bin = cycStop();
+  SREG = sreg;
+}
+
+// 다중 게이트 ISR 본체 (micros() 포함): 채널 1개만 떨어짐 / 모든 채널이 한꺼번에 떨어짐
+// (엣지 손실 한계는 진입/복귀까지 포함해 [env:uno_gates_bench]가 핀을 토글해서 직접 잼, GateRig.cpp)
+
+static MultiGateCapture<GATE_RIG_PINS> benchGates;
+
+static void cycMultiGate(uint16_t& one, uint16_t& all)
+{
+  uint32_t t;
+  uint8_t firstMask = pinmap::mask(benchGates.pin(0));
+  uint8_t sreg = SREG;
+  cli();
+  benchGates.isrWith(0xFF);
+  cycStart();
+  benchGates.isrWith((uint8_t)~firstMask);
+  one = cycStop();
+  benchGates.isrWith(0xFF);
+  cycStart();
+  benchGates.isrWith(0x00);
+  all = cycStop();
+  SREG = sreg;
+  for (uint8_t ch = 0; ch < benchGates.CHANNELS; ch++)
+    while (benchGates.poll(ch, t)) { }
+}
+
+static void cycleCounts()
+{
+  while (!buzzer.isIdle()) { }
+  uint8_t a = TCCR1A, b = TCCR1B;
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10); // clk/1, 62.5ns
+
+  cycOverhead = 0;
+  cycStart();
+  cycOverhead = cycStop();
+
+  report(F("cyc_edge_capture"), F("cycles"), cycEdgeCapture());
+  report(F("cyc_as5600_read"),  F("cycles"), cycAs5600Read());
+  report(F("cyc_lcd_char"),     F("cycles"), cycLcdChar());
+  uint16_t sample, bin;
+  cycFreqTracker(sample, bin);
+  report(F("cyc_freq_sample"),  F("cycles"), sample);
+  report(F("cyc_freq_bin"),     F("cycles"), bin);
+  uint16_t one, all;
+  cycMultiGate(one, all);
+  report(F("cyc_gate_isr_1ch"), F("cycles"), one);
+  report(F("cyc_gate_isr_all"), F("cycles"), all);
+
+  TCCR1A = a;
+  TCCR1B = b;
+  buzzer.begin();
+}
+
+// LCD 갱신이 I2C 각도 경로에서도 진행되는지: 화면 32칸을 바꿔 놓고 100ms 동안 bus.service()만 돌림
+// (1ms 센서 주기 사이에 한 글자가 안 들어가도 LCD_STARVE_PERIODS마다 한 글자는 나가야 함)
+static void lcdUnderI2c()
+{
+  AngleSource::Kind saved = angleSource.kind();
+  selectAngleSource(AngleSource::SRC_I2C);
+  for (uint8_t r = 0; r < 2; r++)
+  {
+    lcd.setCursor(0, r);
+    for (uint8_t c = 0; c < 16; c++) lcd.write('#');
+  }
+
+  AngleSample s;
+  unsigned long count = 0;
+  uint32_t flushes = bus.lcdFlushes();
+  unsigned long start = micros();
+  while (micros() - start < BENCH_WINDOW_US)
+  {
+    bus.service();
+    while (angleSource.pop(s)) count++;
+  }
+  flushes = bus.lcdFlushes() - flushes;
+  selectAngleSource(saved);
+  lcd.clear();
+  lcd.flushAll();
+
+  report(F("lcd_flush_i2c"),      F("chars_per_s"),   flushes * (1000000UL / BENCH_WINDOW_US));
+  report(F("angle_i2c_rate_lcd"), F("samples_per_s"), count * (1000000UL / BENCH_WINDOW_US));
+}
+
+void runBenchmarks()
+{
+  Serial.println(F("===== Benchmarks ====="));
+  report(F("poll_digitalRead"), F("loops_per_s"), pollRate_digitalRead());
+  report(F("poll_fastpin"),     F("loops_per_s"), pollRate_fastPin());
+  buzzerLoad();
+  as5600ReadCost();
+  anglePath(AngleSource::SRC_I2C,    F("angle_i2c_rate"),    F("angle_i2c_jitter"));
+  anglePath(AngleSource::SRC_ANALOG, F("angle_analog_rate"), F("angle_analog_jitter"));
+  lcdUnderI2c();
+  eventLogRoundTrip();
+  cycleCounts();
+  Serial.println(F("bench,end"));
+}
+#endif
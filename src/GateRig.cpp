@@ -0,0 +1,195 @@
+#ifdef MULTI_GATE
+#include <Arduino.h>
+#include "GateRig.h"
+#include "Pins.h"
+#include "MultiGate.h"
+#include "PeriodFusion.h"
+#include "DetectorParams.h"
+
+#define RIG_SWINGS 10     // 채널마다 이만큼 왕복하면 결과 내고 다음 실행 시작
+#define RIG_IDLE_MS 5000  // 이 시간 동안 엣지가 없으면 (진자 멈춤) 채널 초기화
+
+typedef MultiGateCapture<GATE_RIG_PINS> RigGates;
+static_assert(RigGates::PORT_ID == pinmap::PORT_ID_D, "PCINT2_vect below assumes the rig pins are on port D");
+
+static RigGates gates;
+
+ISR(PCINT2_vect)
+{
+  gates.isr();
+}
+
+struct RigChannel
+{
+  SwingStats stats;
+  uint32_t lastMs;
+  uint16_t run;
+  bool active;
+};
+
+static RigChannel channels[RigGates::CHANNELS];
+
+static void report(uint8_t ch, const RigChannel& c, const ClockCal& clk)
+{
+  Serial.print(F("rig,")); Serial.print(ch);
+  Serial.print(','); Serial.print(gates.pin(ch));
+  Serial.print(','); Serial.print(c.run);
+  Serial.print(','); Serial.print(c.stats.count());
+  Serial.print(','); Serial.print(clk.toSec(c.stats.meanUs()), 6);
+  Serial.print(','); Serial.print(clk.toSec(c.stats.semUs()), 7);
+  Serial.print(','); Serial.println(gates.dropped(ch));
+}
+
+#ifdef BENCH
+// [추가] 엣지 처리 한계를 보드에서 직접 잼 ([env:uno_gates_bench], 게이트를 뽑고 돌림: 핀을 출력으로 씀)
+// 게이트 핀을 출력으로 바꿔 토글해도 PCINT가 걸림 → 간격을 줄여 가며 떨어지는 엣지를 BENCH_EDGES개씩 만들고
+// 받은 수(poll)와 큐가 차서 버린 수(dropped)를 셈. 나머지(만든 수 - 받은 수 - 버린 수)는 ISR이 따라가지 못해
+// 핀 변화 플래그 하나에 겹쳐 사라진 엣지. 만든 만큼 다 받은 가장 빠른 간격 = 최대 엣지율 (실제 경과 시간으로 계산).
+// 간격은 Timer1(clk/1) 카운터로 맞춤 → 부저 PWM 설정은 저장했다가 되돌림.
+#define BENCH_EDGES 200
+
+static const uint16_t BENCH_PERIODS[] = { 3200, 1600, 1067, 800, 640, 533, 457, 400, 356, 320,
+                                          291, 267, 246, 229, 213, 200, 178, 160, 128 }; // 사이클 / 엣지
+
+static void benchReport(const __FlashStringHelper* name, const __FlashStringHelper* unit, unsigned long value)
+{
+  Serial.print(F("bench,")); Serial.print(name);
+  Serial.print(','); Serial.print(unit);
+  Serial.print(','); Serial.println(value);
+}
+
+struct BurstResult
+{
+  unsigned long rate;  // 실제로 만든 엣지 / 초 (모든 채널 합)
+  uint16_t made;
+  uint16_t got;
+  uint16_t dropped;
+};
+
+// mask 핀들을 periodCycles마다 한꺼번에 떨어뜨림 (사이에서 큐를 비움 = runGateRig의 loop 역할)
+static BurstResult toggleBurst(uint8_t mask, uint16_t periodCycles)
+{
+  BurstResult r = { 0, 0, 0, 0 };
+  uint8_t before[RigGates::CHANNELS];
+  uint8_t chans = 0;
+  for (uint8_t ch = 0; ch < RigGates::CHANNELS; ch++)
+  {
+    before[ch] = gates.dropped(ch);
+    if (mask & pinmap::mask(gates.pin(ch))) chans++;
+  }
+
+  uint32_t t;
+  uint16_t half = periodCycles / 2;
+  uint16_t next = TCNT1 + half;
+  unsigned long start = micros();
+  for (uint16_t i = 0; i < 2 * BENCH_EDGES; i++)
+  {
+    while ((int16_t)(TCNT1 - next) < 0) { }
+    next += half;
+    if (i & 1) PORTD |= mask;
+    else       PORTD &= (uint8_t)~mask;
+    for (uint8_t ch = 0; ch < RigGates::CHANNELS; ch++)
+      while (gates.poll(ch, t)) r.got++;
+  }
+  unsigned long us = micros() - start;
+  delayMicroseconds(100);
+  for (uint8_t ch = 0; ch < RigGates::CHANNELS; ch++)
+  {
+    while (gates.poll(ch, t)) r.got++;
+    r.dropped += (uint8_t)(gates.dropped(ch) - before[ch]);
+  }
+  r.made = BENCH_EDGES * chans;
+  r.rate = us ? (unsigned long)r.made * 1000000UL / us : 0;
+  return r;
+}
+
+// 간격을 줄여 가며 처음으로 엣지를 잃을 때까지: 잃지 않은 가장 빠른 율, 처음 잃은 율과 그때 버린/사라진 수
+static void benchSweep(uint8_t mask, const __FlashStringHelper* okName, const __FlashStringHelper* lostRateName,
+                       const __FlashStringHelper* droppedName, const __FlashStringHelper* mergedName)
+{
+  unsigned long best = 0;
+  BurstResult fail = { 0, 0, 0, 0 };
+  for (uint8_t i = 0; i < sizeof(BENCH_PERIODS) / sizeof(BENCH_PERIODS[0]); i++)
+  {
+    gates.begin(0);
+    PORTD |= mask;       // HIGH에서 시작 (풀업과 같은 레벨)
+    DDRD |= mask;        // 출력
+    BurstResult r = toggleBurst(mask, BENCH_PERIODS[i]);
+    if (r.got == r.made) { best = r.rate; continue; }
+    fail = r;
+    break;
+  }
+  benchReport(okName,       F("edges_per_s"), best);
+  benchReport(lostRateName, F("edges_per_s"), fail.rate);      // 0 = 가장 빠른 간격까지 잃지 않음
+  benchReport(droppedName,  F("edges"),       fail.dropped);   // 큐 넘침 (loop가 못 비움)
+  benchReport(mergedName,   F("edges"),       fail.made - fail.got - fail.dropped); // ISR을 못 따라감
+}
+
+static void benchGateRig()
+{
+  uint8_t a = TCCR1A, b = TCCR1B;
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10); // clk/1, 62.5ns
+
+  Serial.println(F("===== Gate rig benchmarks ====="));
+  benchSweep(pinmap::mask(gates.pin(0)), F("gate_rig_edges_per_s"), F("gate_rig_lost_rate"),
+             F("gate_rig_lost_dropped"), F("gate_rig_lost_merged"));
+  benchSweep(RigGates::mask(), F("gate_rig_edges_per_s_batch"), F("gate_rig_lost_rate_batch"),
+             F("gate_rig_lost_dropped_batch"), F("gate_rig_lost_merged_batch"));
+  Serial.println(F("bench,end"));
+
+  TCCR1A = a;
+  TCCR1B = b;
+  TCNT1 = 0;
+}
+#endif
+
+void runGateRig(const ClockCal& clk)
+{
+  // [추가] 게이트 시각을 흔드는 다른 인터럽트를 끔: ADC(팟 ≈1kHz, 아날로그 각도 경로면 9.6kHz)와 버튼/부저 틱(1kHz, Timer0 COMPB).
+  // 남는 것은 millis()용 Timer0 오버플로와 Serial 송신뿐. (측정대는 팟/버튼/부저를 안 씀)
+  ADCSRA = _BV(ADIF);
+  TIMSK0 &= (uint8_t)~_BV(OCIE0B);
+
+#ifdef BENCH
+  benchGateRig();
+#endif
+
+  for (uint8_t ch = 0; ch < RigGates::CHANNELS; ch++)
+  {
+    channels[ch].stats.reset();
+    channels[ch].run = 1;
+    channels[ch].active = false;
+  }
+  gates.begin(DET_PHOTO_DEBOUNCE_MS * 1000UL);
+  Serial.print(F("rig,begin,")); Serial.println(RigGates::CHANNELS);
+
+  for (;;)
+  {
+    uint32_t ms = millis();
+    for (uint8_t ch = 0; ch < RigGates::CHANNELS; ch++)
+    {
+      RigChannel& c = channels[ch];
+      uint32_t t;
+      while (gates.poll(ch, t))
+      {
+        c.stats.add(t);
+        c.lastMs = ms;
+        c.active = true;
+        if (c.stats.count() >= RIG_SWINGS)
+        {
+          report(ch, c, clk);
+          c.run++;
+          c.stats.reset();
+          c.stats.add(t); // 마지막 통과가 다음 실행의 시작
+        }
+      }
+      if (c.active && ms - c.lastMs > RIG_IDLE_MS)
+      {
+        c.stats.reset();
+        c.active = false;
+      }
+    }
+  }
+}
+#endif
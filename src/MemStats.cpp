@@ -0,0 +1,57 @@
+#include "MemStats.h"
+
+#ifdef __AVR__
+extern uint8_t __data_start;
+extern uint8_t __bss_end;
+extern uint8_t __heap_start;
+extern void* __brkval;
+
+static const uint8_t PAINT = 0xC5;
+
+// .init3: SP/r1 초기화(.init2) 뒤, .data/.bss 복사(.init4) 전. 스택에 아무것도 없을 때라 끝까지 칠해도 안전
+extern "C" void memstatsPaint(void) __attribute__((naked, used, section(".init3")));
+extern "C" void memstatsPaint(void)
+{
+    for (uint8_t* p = &__bss_end; p <= (uint8_t*)RAMEND; p++) *p = PAINT;
+}
+
+static uint8_t* heapEnd()
+{
+    return __brkval ? (uint8_t*)__brkval : &__heap_start;
+}
+
+namespace memstats
+{
+    uint16_t staticBytes() { return (uint16_t)(&__bss_end - &__data_start); }
+    uint16_t freeNow()     { return (uint16_t)((uint8_t*)SP - heapEnd()); }
+
+    uint16_t stackUnused()
+    {
+        uint8_t* p = heapEnd();
+        uint16_t n = 0;
+        while (p <= (uint8_t*)RAMEND && *p == PAINT) { p++; n++; }
+        return n;
+    }
+
+    uint16_t stackPeak()
+    {
+        return (uint16_t)((uint8_t*)RAMEND - heapEnd() + 1) - stackUnused();
+    }
+}
+#else
+namespace memstats
+{
+    uint16_t staticBytes() { return 0; }
+    uint16_t freeNow()     { return 0; }
+    uint16_t stackUnused() { return 0; }
+    uint16_t stackPeak()   { return 0; }
+}
+#endif
+
+void memstats::print(Print& out)
+{
+    out.print(F("ram_static,"));       out.println(staticBytes());
+    out.print(F("ram_free_now,"));     out.println(freeNow());
+    out.print(F("stack_peak,"));       out.println(stackPeak());
+    out.print(F("stack_unused_min,")); out.println(stackUnused());
+}
@@ -0,0 +1,179 @@
+#ifndef ARDUINO
+// ==================== 세션 재생 (호스트) ====================
+// [env:native_replay] 프로그램: 기록 파일(Serial 'R' ~ 'r' 캡처)의 r/d 줄을 보드와 같은 상태 머신(StateMachine.cpp)에
+// 한 패스씩 넣고 확인:
+//   패스마다 상태 지문 = 기록 줄 끝 "*<crc>" (다르면 그 줄에서 멈춤: 뒤는 이미 갈라진 상태라 의미 없음)
+//   패스가 낸 swing/result 줄 = 기록에서 그 패스 줄 바로 앞에 나온 swing/result 줄 (보드는 패스 중에 찍고 끝에 d 줄)
+// 기다림(holdMs)이 없고 기록된 패스만 돌리므로 실제 시간보다 훨씬 빠름.
+//   program [--lcd] <기록 파일>...
+// 출력: 파일마다 "replay,<파일>,<ok|fail>,<패스 수>,<지문 비교 수>,<결과 줄 수>,<기록 시간 s>,<재생 ms>,<배속>"
+//   실패하면 앞에 "crc,<줄 번호>,<기록>,<재생>" 또는 "out,<줄 번호>,<기록 줄>,<재생 줄>" (--lcd면 그때 화면 "lcd,<행>")
+//   지문이 하나도 없는 기록(지문을 넣기 전 펌웨어)도 실패. 하나라도 실패하면 종료 코드 1
+// 여러 파일을 나눠서 동시에 돌리는 건 tools/replay_native.py.
+#include <Arduino.h>
+#include <stdlib.h>
+#include <chrono>
+#include "StateMachine.h"
+#include "Buzzer.h"
+
+HostSerial Serial;
+ShadowLcd lcd(0x27, 16, 2);
+BuzzerSequencer buzzer;
+
+void holdMs(unsigned long) {}
+void resetFrequency() { freqTracker.reset(); }
+void printTrack() {} // 각도 스트림은 기록에 없음 (패스 입력 밖)
+
+#define MAX_LINE 256
+#define MAX_OUT 64 // 한 패스가 내는 결과 줄 상한 (swing 10줄 + result)
+
+static bool compared(const char* line)
+{
+  return strncmp(line, "swing,", 6) == 0 || strncmp(line, "result,", 7) == 0;
+}
+
+// 결과 줄 모음 (기록 쪽 / 재생 쪽)
+struct OutLines
+{
+  char lines[MAX_OUT][MAX_LINE];
+  int n;
+
+  void add(const char* line)
+  {
+    if (n < MAX_OUT) snprintf(lines[n], MAX_LINE, "%s", line);
+    n++;
+  }
+};
+
+static OutLines expected, produced;
+
+static void onSerialLine(const char* line)
+{
+  if (compared(line)) produced.add(line);
+}
+
+static void printLcd()
+{
+  for (uint8_t r = 0; r < ShadowLcd::ROWS; r++)
+  {
+    char row[ShadowLcd::COLS + 1];
+    for (uint8_t c = 0; c < ShadowLcd::COLS; c++) row[c] = lcd.cell(r, c);
+    row[ShadowLcd::COLS] = '\0';
+    printf("lcd,%s\n", row);
+  }
+}
+
+// 이번 패스가 낸 결과 줄과 기록의 결과 줄이 같은지 (다르면 처음 다른 줄을 찍음)
+static bool sameOutputs(long lineNo)
+{
+  int n = expected.n > produced.n ? expected.n : produced.n;
+  for (int i = 0; i < n && i < MAX_OUT; i++)
+  {
+    const char* e = i < expected.n ? expected.lines[i] : "";
+    const char* g = i < produced.n ? produced.lines[i] : "";
+    if (strcmp(e, g) != 0)
+    {
+      printf("out,%ld,%s,%s\n", lineNo, e, g);
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool replayFile(const char* path, bool showLcd)
+{
+  FILE* f = fopen(path, "r");
+  if (!f)
+  {
+    printf("replay,%s,fail,0,0,0,0,0,0\n", path);
+    return false;
+  }
+
+  auto wallStart = std::chrono::steady_clock::now();
+  resetSession();
+  clockCal.use(0.0);
+  expected.n = produced.n = 0;
+
+  char line[MAX_LINE];
+  long lineNo = 0, passes = 0, hashes = 0, outputs = 0;
+  uint32_t firstMs = 0, lastMs = 0; // 세션의 첫/마지막 패스 시각 (기록 시간 = 세션마다 합)
+  double recordedSec = 0;
+  bool inSession = false, sessionPasses = false, ok = true;
+  PassInputs in = PassInputs();
+
+  while (ok && fgets(line, sizeof(line), f))
+  {
+    lineNo++;
+    line[strcspn(line, "\r\n")] = '\0';
+
+    if (strcmp(line, "rec,begin") == 0) // 보드의 'R'과 같은 출발점, clk 줄이 없는 옛 기록 = 보정 없음
+    {
+      if (sessionPasses) recordedSec += (lastMs - firstMs) / 1000.0;
+      resetSession();
+      clockCal.use(0.0);
+      expected.n = produced.n = 0;
+      inSession = true;
+      sessionPasses = false;
+      continue;
+    }
+    if (!inSession) continue;
+
+    float ppm;
+    if (strncmp(line, "clk,", 4) == 0 && ClockCal::parse(line + 4, ppm)) { clockCal.use(ppm); continue; }
+    if (strcmp(line, "rec,end") == 0)
+    {
+      if (sessionPasses) recordedSec += (lastMs - firstMs) / 1000.0;
+      inSession = sessionPasses = false;
+      continue;
+    }
+    if (compared(line)) { expected.add(line); continue; }
+
+    if (!session::parseRecord(line, in) && !session::parseDelta(line, in)) continue; // 그 밖의 Serial 줄 (명령 응답, trace 등)
+    if (!sessionPasses) firstMs = in.ms;
+    sessionPasses = true;
+    lastMs = in.ms;
+
+    passIn = in;
+    runPass();
+    passes++;
+
+    outputs += produced.n;
+    if (!sameOutputs(lineNo)) ok = false;
+    expected.n = produced.n = 0;
+
+    uint16_t want;
+    if (session::parseHash(line, want))
+    {
+      hashes++;
+      uint16_t got = stateCrc();
+      if (got != want)
+      {
+        printf("crc,%ld,%X,%X\n", lineNo, want, got);
+        ok = false;
+      }
+    }
+  }
+  fclose(f);
+  if (sessionPasses) recordedSec += (lastMs - firstMs) / 1000.0;
+  if (ok && expected.n > 0) { printf("out,%ld,%s,\n", lineNo, expected.lines[0]); ok = false; } // 마지막 패스 뒤 결과 줄
+  if (hashes == 0) ok = false;
+  if (!ok && showLcd) printLcd();
+
+  double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+  printf("replay,%s,%s,%ld,%ld,%ld,%.1f,%.1f,%.0f\n", path, ok ? "ok" : "fail", passes, hashes, outputs,
+         recordedSec, wallMs, wallMs > 0 ? recordedSec * 1000.0 / wallMs : 0.0);
+  return ok;
+}
+
+int main(int argc, char** argv)
+{
+  Serial.onLine = onSerialLine;
+  bool showLcd = false, allOk = true;
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--lcd") == 0) { showLcd = true; continue; }
+    if (!replayFile(argv[i], showLcd)) allOk = false;
+  }
+  return allOk ? 0 : 1;
+}
+#endif
@@ -0,0 +1,156 @@
+#include "SessionRecord.h"
+#include <stdlib.h>
+#include <string.h>
+
+namespace session
+{
+    bool inputsChanged(const PassInputs& prev, const PassInputs& cur)
+    {
+        return (cur.flags & (IN_A | IN_B | IN_GATE))
+            || cur.flags != prev.flags
+            || cur.angle != prev.angle
+            || cur.pot != prev.pot;
+    }
+
+    // CRC-16/CCITT (비트 단위, 테이블 없음)
+    uint16_t crc16(const void* data, uint16_t n, uint16_t crc)
+    {
+        const uint8_t* p = (const uint8_t*)data;
+        while (n--)
+        {
+            crc ^= (uint16_t)(*p++) << 8;
+            for (uint8_t i = 0; i < 8; i++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+        return crc;
+    }
+
+    static void printHash(Print& out, uint16_t hash)
+    {
+        out.print('*');
+        out.println(hash, HEX);
+    }
+
+    void printRecord(Print& out, const PassInputs& in, uint16_t hash)
+    {
+        out.print(F("r,"));  out.print(in.us);
+        out.print(',');      out.print(in.ms);
+        out.print(',');      out.print(in.angle);
+        out.print(',');      out.print(in.pot);
+        out.print(',');      out.print(in.flags);
+        if (in.flags & IN_GATE) { out.print(','); out.print(in.gateUs); }
+        printHash(out, hash);
+    }
+
+    bool parseRecord(const char* line, PassInputs& in)
+    {
+        if (line[0] != 'r' || line[1] != ',') return false;
+        char* p = (char*)line + 2;
+        uint32_t v[5];
+        for (uint8_t i = 0; i < 5; i++)
+        {
+            char* end;
+            v[i] = strtoul(p, &end, 10);
+            if (end == p) return false;
+            p = (*end == ',') ? end + 1 : end;
+        }
+        in.us = v[0];
+        in.ms = v[1];
+        in.angle = (uint16_t)v[2];
+        in.pot = (uint16_t)v[3];
+        in.flags = (uint8_t)v[4];
+        in.gateUs = (in.flags & IN_GATE) ? strtoul(p, nullptr, 10) : 0;
+        return true;
+    }
+
+    // 빈 칸은 바로 쓰지 않고 세어 두었다가 뒤에 값이 올 때 한꺼번에 (끝의 빈 칸은 안 씀)
+    static void separate(Print& out, uint8_t& empty)
+    {
+        while (empty) { out.print(','); empty--; }
+        out.print(',');
+    }
+
+    void printDelta(Print& out, const PassInputs& prev, const PassInputs& in, uint16_t hash)
+    {
+        out.print(F("d,"));  out.print(in.us - prev.us);
+        out.print(',');      out.print(in.ms - prev.ms);
+        uint8_t empty = 0;
+        if (in.angle != prev.angle) { separate(out, empty); out.print(in.angle); } else empty++;
+        if (in.pot != prev.pot)     { separate(out, empty); out.print(in.pot); }   else empty++;
+        if (in.flags != prev.flags) { separate(out, empty); out.print(in.flags); } else empty++;
+        if (in.flags & IN_GATE)     { separate(out, empty); out.print((int32_t)(in.gateUs - in.us)); }
+        printHash(out, hash);
+    }
+
+    // ','로 시작하는 다음 칸. 값이 있으면 true, 빈 칸이나 줄 끝이면 false
+    static bool nextField(const char*& p, int32_t& v)
+    {
+        if (*p != ',') return false;
+        p++;
+        char* end;
+        v = strtol(p, &end, 10);
+        bool got = end != p;
+        p = end;
+        return got;
+    }
+
+    bool parseDelta(const char* line, PassInputs& in)
+    {
+        if (line[0] != 'd' || line[1] != ',') return false;
+        const char* p = line + 2;
+        char* end;
+        uint32_t dus = strtoul(p, &end, 10);
+        if (end == p || *end != ',') return false;
+        p = end + 1;
+        uint32_t dms = strtoul(p, &end, 10);
+        if (end == p) return false;
+        p = end;
+
+        PassInputs next = in;
+        next.us += dus;
+        next.ms += dms;
+        int32_t v;
+        if (nextField(p, v)) next.angle = (uint16_t)v;
+        if (nextField(p, v)) next.pot = (uint16_t)v;
+        if (nextField(p, v)) next.flags = (uint8_t)v;
+        next.gateUs = 0;
+        if (next.flags & IN_GATE)
+        {
+            if (!nextField(p, v)) return false;
+            next.gateUs = next.us + v;
+        }
+        in = next;
+        return true;
+    }
+
+    bool parseHash(const char* line, uint16_t& hash)
+    {
+        const char* p = strchr(line, '*');
+        if (!p) return false;
+        char* end;
+        unsigned long v = strtoul(p + 1, &end, 16);
+        if (end == p + 1 || *end != '\0' || v > 0xFFFF) return false;
+        hash = (uint16_t)v;
+        return true;
+    }
+
+    const char* LineReader::poll(Stream& in)
+    {
+        while (in.available())
+        {
+            char c = in.read();
+            if (c == '\r') continue;
+            if (c == '\n')
+            {
+                bool ok = !_overflow;
+                _buf[_len] = '\0';
+                _len = 0;
+                _overflow = false;
+                if (ok) return _buf;
+                continue;
+            }
+            if (_len < sizeof(_buf) - 1) _buf[_len++] = c;
+            else _overflow = true;
+        }
+        return nullptr;
+    }
+}
@@ -0,0 +1,1029 @@
+#include <Arduino.h>
+#include <math.h>
+#include "StateMachine.h"
+#include "Buzzer.h"
+#include "AmplitudeCorrection.h"
+#include "DetectorParams.h" // [추가] 검출 임계값 (tools/tune_detector.py 생성)
+
+// ==================== 측정 상태 머신 ====================
+// 보드 loop()와 재생 호스트(ReplayHost.cpp)가 같이 돌리는 패스. 화면/부저/Serial 말고는 하드웨어를 안 봄 (StateMachine.h)
+
+#define swing 10          // 측정할 왕복 횟수
+#define MIN_SWINGS 3      // [추가] Mode 5 조기 종료 시 최소 왕복 횟수
+#define FUSE_Z_LIMIT 3.0  // [추가] Hall/Photo 주기 차이가 합성 불확도의 이 배수를 넘으면 어긋남 표시
+
+// ==================== 전역 변수 ====================
+int mode = 0;
+int measureSourceMode = 5; // [추가] 측정 모드가 어디였는지 기억 (3=Photo, 5=Hall)
+bool fusedRun = false;     // [추가] Hall+Photo 동시 측정 (Mode 5 + 게이트 엣지 캡처)
+
+// 모드 0에서 입력할 초기 스윙 시작 각도
+float SetAngle = 0.0;
+
+// 관성모멘트 계산 물리량
+float mass_kg = 0.0;     
+float distance_m = 0.0;  
+float time_s = 0.0;      // 측정된 주기(T)
+
+// Mode 2에서 잡은 0점 (Mode 3, 5에서 사용)
+float angleOffset = 0.0; 
+
+ModeState modeState;
+
+// [추가] 측정 이벤트 로그 (Mode 3 통과 / Mode 5 피크 시각, 델타 압축)
+// 모드 공용체 밖에 둬서 Mode 4/6을 거쳐 결과 화면(step 3)으로 돌아와도 남아 있음.
+// 주기/관성모멘트 같은 값은 저장하지 않고 필요할 때 여기서 계산.
+RunLog runLog;
+
+// [추가] 피크 진폭 감쇠 (로그 감소율, Q) - 측정 로그처럼 결과 화면으로 돌아와도 남음
+// Mode 5: 검출한 피크마다, Mode 3: AS5600이 있으면 통과 사이 최대 각도마다
+DecayEstimator runDecay;
+
+// [추가] Hall+Photo 측정에서 게이트 엣지로 쌓는 왕복 주기 통계 (홀 쪽은 runLog에서 계산)
+SwingStats gateStats;
+
+// [추가] Mode 5 측정 중 각도 스트림 전체로 주기 추적 (피크 시각과 따로, 20Hz 갱신)
+// 패스 입력 스냅샷 밖의 값이라 상태 머신 판단에는 안 쓰고 화면/Serial 표시에만 씀
+FreqTracker<> freqTracker;
+
+// [추가] 레조네이터 오차 보정 (EEPROM에 저장한 ppm, 주기 us → s 변환은 모두 여기로)
+ClockCal clockCal;
+
+// [추가] 패스 입력 스냅샷: 상태 머신은 millis()/micros()/핀/센서를 직접 보지 않고 이것만 봄
+// (기록한 스냅샷을 그대로 다시 넣으면 같은 결과 → 재생 가능)
+PassInputs passIn;
+
+// 모드 변경 시 LCD 초기화 함수
+void updateLcdDisplay() 
+{
+  lcd.clear(); 
+  lcd.setCursor(0, 0); 
+
+  switch (mode) 
+  {
+    case 0: lcd.print(F("== Set angle =="));   break;
+    case 1: lcd.print(F("== which mode? ==")); break;
+    case 2: lcd.print(F("== Hall Cal. =="));   break;
+    case 3: lcd.print(F("== Photo Mode =="));  break; // [변경] TBD -> Photo Mode
+    case 4: lcd.print(F("== Set M & D =="));   break;
+    case 5: lcd.print(fusedRun ? F("== Hall+Photo ==") : F("== Hall Mode ==")); break;
+    case 6: lcd.print(F("== Inertia Cal ==")); break;
+  }
+}
+
+// 로그에서 왕복 주기(us)를 차례로 꺼냄 (로그 = 반주기 간격 이벤트 시각, 이벤트 2개 = 왕복 1번)
+struct SwingReader 
+{
+  RunLog::Reader r;
+  uint32_t t0;
+  bool ok;
+
+  SwingReader(const RunLog& log) : r(log) { ok = r.next(t0); }
+
+  bool next(uint32_t& periodUs) 
+  {
+    uint32_t t1, t2;
+    if (!ok || !r.next(t1) || !r.next(t2)) return false;
+    periodUs = t2 - t0;
+    t0 = t2;
+    return true;
+  }
+};
+
+// 측정 결과: 왕복별 주기를 Serial로
+void printSwingPeriods(const RunLog& log) 
+{
+  SwingReader sw(log);
+  uint32_t periodUs;
+  for (int k = 1; sw.next(periodUs); k++) {
+    Serial.print(F("swing,")); Serial.print(k);
+    Serial.print(','); Serial.println(clockCal.toSec(periodUs), 6);
+  }
+}
+
+// 감쇠 결과: "decay,<피크 수>,<로그 감소율>,<감쇠비>,<Q>,<지금 진폭 deg>"
+void printDecay() 
+{
+  Serial.print(F("decay,")); Serial.print(runDecay.count());
+  Serial.print(','); Serial.print(runDecay.logDecrement(), 5);
+  Serial.print(','); Serial.print(runDecay.dampingRatio(), 6);
+  Serial.print(','); Serial.print(runDecay.qFactor(), 1);
+  Serial.print(','); Serial.println(runDecay.amplitudeNow(), 2);
+}
+
+// 로그에 담긴 왕복 수 (반주기 이벤트 2개 = 왕복 1번)
+int runLogSwings() 
+{
+  return runLog.count() > 0 ? (runLog.count() - 1) / 2 : 0;
+}
+
+// 로그 처음~마지막 이벤트 사이 시간 (s)
+float runLogSpanSec() 
+{
+  return clockCal.toSec(runLog.last() - runLog.first());
+}
+
+// [추가] 왕복마다 그 왕복 진폭으로 작은 각 주기로 보정한 평균 주기 (s)
+//   진폭 = 감쇠 직선(runDecay) 위 왕복 가운데 피크 값, 진폭 기록이 없으면(포토 전용) SetAngle
+//   peakOffset: 왕복 j 가운데 피크 번호 = 2j + peakOffset (Mode 5: 1, Mode 3: 0.5)
+float smallAnglePeriod(float peakOffset) 
+{
+  SwingReader sw(runLog);
+  uint32_t periodUs;
+  float sum = 0.0;
+  int n = 0;
+  while (sw.next(periodUs)) {
+    float amp = runDecay.count() > 0 ? runDecay.amplitudeAt(2 * n + peakOffset) : SetAngle;
+    sum += ampcorr::toSmallAngle(periodUs, amp);
+    n++;
+  }
+  return n > 0 ? clockCal.toSec(sum / n) : 0.0;
+}
+
+// 보정 결과: "amp_corr,<첫 왕복 진폭>,<마지막 왕복 진폭>,<측정 평균 T>,<보정 T0>"
+void printAmpCorrection(float peakOffset) 
+{
+  int n = runLogSwings();
+  bool measured = runDecay.count() > 0;
+  Serial.print(F("amp_corr,")); Serial.print(measured ? runDecay.amplitudeAt(peakOffset) : SetAngle, 2);
+  Serial.print(','); Serial.print(measured ? runDecay.amplitudeAt(2 * (n - 1) + peakOffset) : SetAngle, 2);
+  Serial.print(','); Serial.print(n > 0 ? runLogSpanSec() / n : 0.0, 6);
+  Serial.print(','); Serial.println(smallAnglePeriod(peakOffset), 6);
+}
+
+// [추가] 측정 로그(홀 피크)의 왕복 주기 통계
+SwingStats runLogStats() 
+{
+  SwingStats st;
+  st.reset();
+  RunLog::Reader r(runLog);
+  uint32_t t;
+  while (r.next(t)) st.add(t);
+  return st;
+}
+
+// [추가] Hall+Photo 교차 검증: 홀 피크 주기와 게이트 엣지 주기를 역분산 가중으로 합침
+// 둘 다 왕복 2개 이상이어야 함 (아니면 false → 홀 결과만 씀)
+bool fusedPeriod(FusedPeriod& f) 
+{
+  if (!fusedRun || gateStats.count() < 2) return false;
+  SwingStats hall = runLogStats();
+  if (hall.count() < 2) return false;
+  f = fusePeriods(clockCal.toSec(hall.meanUs()), clockCal.toSec(hall.semUs()),
+                  clockCal.toSec(gateStats.meanUs()), clockCal.toSec(gateStats.semUs()), FUSE_Z_LIMIT);
+  return true;
+}
+
+// 교차 검증 결과: "fuse,<홀 왕복 수>,<T_hall>,<s_hall>,<게이트 왕복 수>,<T_gate>,<s_gate>,<T>,<sigma>,<z>,<어긋남 0/1>"
+//   (게이트 왕복이 모자라면 T/sigma = 홀 값, z = 0)
+void printFusion() 
+{
+  SwingStats hall = runLogStats();
+  FusedPeriod f;
+  if (!fusedPeriod(f)) {
+    f.T = clockCal.toSec(hall.meanUs());
+    f.sigma = clockCal.toSec(hall.semUs());
+    f.z = 0.0;
+    f.disagree = false;
+  }
+  Serial.print(F("fuse,")); Serial.print(hall.count());
+  Serial.print(','); Serial.print(clockCal.toSec(hall.meanUs()), 6);
+  Serial.print(','); Serial.print(clockCal.toSec(hall.semUs()), 7);
+  Serial.print(','); Serial.print(gateStats.count());
+  Serial.print(','); Serial.print(clockCal.toSec(gateStats.meanUs()), 6);
+  Serial.print(','); Serial.print(clockCal.toSec(gateStats.semUs()), 7);
+  Serial.print(','); Serial.print(f.T, 6);
+  Serial.print(','); Serial.print(f.sigma, 7);
+  Serial.print(','); Serial.print(f.z, 2);
+  Serial.print(','); Serial.println(f.disagree ? 1 : 0);
+}
+
+// 현재 모드의 진행 단계 (스텝이 없는 모드는 0)
+int currentStep() 
+{
+  switch (mode) 
+  {
+    case 2: return modeState.m2.step;
+    case 3: return modeState.m3.step;
+    case 5: return modeState.m5.step;
+    default: return 0;
+  }
+}
+
+// 관성모멘트 (측정 주기 + 입력한 질량/거리에서 그때그때 계산)
+float inertiaValue() 
+{
+  float T = time_s;
+  float M = mass_kg;
+  float D = distance_m;
+  float g = 9.80665;
+  float PI_VAL = 3.14159265;
+  float I_value = 0.0;
+  
+  if (M > 0 && D > 0) I_value = (T * T * M * g * D) / (4 * PI_VAL * PI_VAL);
+  return I_value;
+}
+
+// 관성모멘트 1차 불확도 (1 sigma)
+//   (sI/I)^2 = (2 sT/T)^2 + (sM/M)^2 + (sD/D)^2
+//   sT = 왕복별 주기의 표준오차, sM/sD = 입력 해상도 0.01의 균등 분포 (0.01/sqrt(12))
+// 정밀한 구간은 tools/inertia_mc.py (Serial의 swing/result 줄 사용)
+float inertiaSigma() 
+{
+  float I_value = inertiaValue();
+  if (I_value <= 0) return 0.0;
+
+  // 첫 주기와의 차이(us)로 합산 (float로 T^2 합을 빼면 자릿수가 다 날아감)
+  SwingReader sw(runLog);
+  uint32_t first, periodUs;
+  float sum = 0.0, sum2 = 0.0;
+  int n = 0;
+  if (sw.next(first)) {
+    n = 1;
+    while (sw.next(periodUs)) {
+      float d = (float)(int32_t)(periodUs - first);
+      sum += d;
+      sum2 += d * d;
+      n++;
+    }
+  }
+  float semT = 0.0;
+  if (n > 1) {
+    float var = (sum2 - sum * sum / n) / (n - 1); // us^2
+    if (var > 0) semT = clockCal.toSec(sqrt(var / n));
+  }
+  FusedPeriod f;
+  if (fusedPeriod(f)) semT = f.sigma; // [추가] Hall+Photo면 합친 주기의 불확도
+
+  const float sRes = 0.01 / sqrt(12.0);
+  float rT = time_s > 0 ? 2.0 * semT / time_s : 0.0;
+  float rM = sRes / mass_kg;
+  float rD = sRes / distance_m;
+  return I_value * sqrt(rT * rT + rM * rM + rD * rD);
+}
+
+// 결과 한 줄: "result,<T_s>,<M_kg>,<D_m>,<I>,<sigma_I>" (기록/재생 비교, tools/inertia_mc.py 입력)
+void printResult() 
+{
+  Serial.print(F("result,")); Serial.print(time_s, 6);
+  Serial.print(','); Serial.print(mass_kg, 2);
+  Serial.print(','); Serial.print(distance_m, 2);
+  Serial.print(','); Serial.print(inertiaValue(), 6);
+  Serial.print(','); Serial.println(inertiaSigma(), 6);
+}
+
+// 모드 전환: 상태 초기화 + 화면 갱신
+void enterMode(int newMode, int step) 
+{
+  mode = newMode;
+  memset(&modeState, 0, sizeof(modeState));
+
+  switch (newMode) 
+  {
+    case 0:
+      modeState.m0.angleQ.configure(4095, 301, 6); // 0.0~30.0도 (0.1도 단위)
+      modeState.m0.shownTenths = -1;
+      break;
+    case 2:
+      modeState.m2.lastStableValue = -1.0;
+      break;
+    case 3:
+      modeState.m3.step = step;
+      modeState.m3.countdown = 3;
+      modeState.m3.lastPhotoState = HIGH;
+      if (step == 3 && !runLog.empty()) modeState.m3.timerStart = 1; // 결과 화면 다시 그리기
+      break;
+    case 4:
+      modeState.m4.lastMappedDigit = -1;
+      modeState.m4.digitQ.configure(4095, 10, 60);
+      break;
+    case 5:
+      modeState.m5.step = step;
+      modeState.m5.countdown = 3;
+      if (step == 3 && !runLog.empty()) modeState.m5.timerStart = 1; // 결과 화면 다시 그리기
+      break;
+    case 6:
+      printResult();
+      break;
+  }
+  updateLcdDisplay();
+}
+
+// 세션 시작 상태 (기록 시작 / 재생 시작이 같은 지점에서 출발하도록)
+void resetSession() 
+{
+  SetAngle = 0.0;
+  mass_kg = 0.0;
+  distance_m = 0.0;
+  time_s = 0.0;
+  angleOffset = 0.0;
+  measureSourceMode = 5;
+  fusedRun = false;
+  runLog.clear();
+  runDecay.reset(); // 앞 측정의 피크가 남아 있으면 재생과 지문이 갈림
+  gateStats.reset();
+  enterMode(0);
+}
+
+// 상태 머신이 들고 있는 상태의 지문 (기록: 상태가 바뀐 패스는 입력이 그대로여도 남김, 재생: 패스마다 비교)
+// 시각 값(stableStartTime, prevTime, timerStart, lastHitMs)은 0인지(시작했는지)만 넣음: 입력이나 스텝/카운트다운/로그 수가
+// 바뀌는 패스에서만 정해지므로 값까지 넣어도 더 잡는 패스가 없고, 재생은 그 패스의 기록 시각으로 같은 값을 만듦.
+// 필드마다 고정 폭으로 넣음 (보드와 재생 호스트의 구조체 배치가 달라도 같은 값).
+// 사칙연산으로만 정해지는 값만 넣음: time_s, runDecay 같은 log/exp/sin 결과는 libm마다 끝자리가 달라서 빼고
+// 재생은 그 값들을 result/swing 줄 글자로 비교.
+uint16_t stateCrc() 
+{
+  session::StateHash h;
+  h.i16(mode);
+  switch (mode)
+  {
+    case 0:
+      h.i16(modeState.m0.angleQ.level()); h.i16(modeState.m0.shownTenths);
+      break;
+    case 1:
+      h.i16(modeState.m1.selection);
+      break;
+    case 2:
+    {
+      const Mode2State& s = modeState.m2;
+      h.i16(s.step); h.u8(s.stableStartTime != 0); h.f32(s.lastStableValue);
+      break;
+    }
+    case 3:
+    {
+      const Mode3State& s = modeState.m3;
+      h.i16(s.step);     h.u8(s.stableStartTime != 0); h.u8(s.timerStart != 0); h.u8(s.prevTime != 0);
+      h.i16(s.countdown); h.i16(s.hitCount); h.i16(s.lastPhotoState); h.u8(s.lastHitMs != 0); h.f32(s.peakAmp);
+      break;
+    }
+    case 4:
+    {
+      const Mode4State& s = modeState.m4;
+      h.i16(s.editingStep);
+      for (uint8_t i = 0; i < 6; i++) h.i16(s.digits[i]);
+      h.i16(s.currentDigitPosition); h.i16(s.lastMappedDigit); h.u8(s.isInputDone); h.i16(s.digitQ.level());
+      break;
+    }
+    case 5:
+    {
+      const Mode5State& s = modeState.m5;
+      h.i16(s.step);     h.u8(s.stableStartTime != 0); h.u8(s.timerStart != 0); h.u8(s.prevTime != 0);
+      h.i16(s.countdown); h.i16(s.swingCount); h.i16(s.prevIntAngle); h.u8(s.readyForPeak);
+      h.f32(s.filteredAbsAngle); h.f32(s.peakAmp);
+      break;
+    }
+  }
+  h.u16(runLog.count());
+  h.u8(runDecay.count());
+  h.u8(gateStats.count());
+  h.f32(SetAngle);   h.f32(angleOffset);
+  h.f32(mass_kg);    h.f32(distance_m);
+  h.i16(measureSourceMode); h.u8(fusedRun);
+  return h.value();
+}
+
+bool passPhoto()    { return passIn.flags & IN_PHOTO; }
+bool passSensorOk() { return passIn.flags & IN_SENSOR; }
+bool passMagnetOk() { return passIn.flags & IN_MAGNET; }
+
+// Mode 4용 화면 업데이트 헬퍼
+void mode4_updateLcd(const __FlashStringHelper* title, int digits[6], int pos, bool isDone) 
+{
+  lcd.clear(); 
+  lcd.setCursor(0, 0); 
+  lcd.print(title);
+
+  char displayString[10];
+  sprintf(displayString, "%d%d%d%d.%d%d", 
+          digits[5], digits[4], digits[3], digits[2], digits[1], digits[0]);
+  lcd.setCursor(0, 1);
+  lcd.print(displayString);
+  lcd.print(F("        ")); 
+}
+
+// Mode 4: 숫자만 바뀌었을 때는 2번째 줄만 다시 씀 (clear 없이)
+void mode4_updateDigits(int digits[6]) 
+{
+  char displayString[10];
+  sprintf(displayString, "%d%d%d%d.%d%d", 
+          digits[5], digits[4], digits[3], digits[2], digits[1], digits[0]);
+  lcd.setCursor(0, 1);
+  lcd.print(displayString);
+}
+
+float mode4_getFinalValue(int digits[6]) {
+  float value = 0.0;
+  value += (float)digits[0] * 0.01;
+  value += (float)digits[1] * 0.1;
+  value += (float)digits[2] * 1.0;
+  value += (float)digits[3] * 10.0;
+  value += (float)digits[4] * 100.0;
+  value += (float)digits[5] * 1000.0;
+  return value;
+}
+
+void mode4_resetInput(int digits[6], int& pos, int& lastDigit, bool& isDone) {
+  for (int i = 0; i < 6; i++) {
+    digits[i] = 0;
+  }
+  pos = 0; 
+  lastDigit = -1;
+  isDone = false;
+}
+
+// ==================== 한 패스 ====================
+// loop()에서 readInputs(passIn) 다음에 부름 (재생 호스트는 기록 줄마다)
+void runPass() 
+{
+  bool A_pressed = passIn.flags & IN_A;
+  bool B_pressed = passIn.flags & IN_B;
+
+  // ----- 모드별 변수: modeState(공용 메모리)의 현재 모드 칸을 가리킴 -----
+  // (다른 모드 칸과 메모리를 공유하므로 mode가 같을 때만 읽고 씀, 진입 시 enterMode()가 초기화)
+  Mode0State& m0 = modeState.m0;
+  Mode1State& m1 = modeState.m1;
+  Mode2State& m2 = modeState.m2;
+  Mode3State& m3 = modeState.m3;
+  Mode4State& m4 = modeState.m4;
+  Mode5State& m5 = modeState.m5;
+
+  switch (mode) 
+  {
+    // ======================================================
+    // Mode 0: Set Target Angle (초기 각도 설정)
+    // ======================================================
+    case 0: 
+    {
+      int tenths = m0.angleQ.update(passIn.pot);
+      float angle = tenths / 10.0;
+
+      // 값이 실제로 바뀔 때만 다시 그림
+      if (tenths != m0.shownTenths)
+      {
+        lcd.setCursor(1, 1);
+        lcd.print(F(" Angle: "));
+        lcd.print(angle, 1);
+        lcd.print(F("  "));
+        m0.shownTenths = tenths;
+      }
+
+      if (A_pressed) 
+      {
+        SetAngle = angle;
+        enterMode(1); // -> Mode 1
+      }
+      break;
+    }
+
+    // ======================================================
+    // Mode 1: Select Sensor (Hall vs Photo)
+    // ======================================================
+    case 1:
+    {
+      // [추가] AS5600이 없으면 포토만 선택 가능
+      if (!passSensorOk()) m1.selection = 1;
+
+      lcd.setCursor(0, 1); 
+      if (!passSensorOk())    lcd.print(F(" [Photo only]   "));
+      else if (m1.selection == 0)    lcd.print(F("[Hall]Photo Both"));
+      else if (m1.selection == 1)    lcd.print(F("Hall[Photo]Both "));
+      else                           lcd.print(F("Hall Photo[Both]")); // [추가] 두 센서 동시
+
+      // B버튼: 선택 변경 (Hall → Photo → Both)
+      if (B_pressed) 
+      {
+         m1.selection = (m1.selection + 1) % 3;
+      }
+
+      // A버튼: 확정
+      if (A_pressed) 
+      {
+        fusedRun = (m1.selection == 2);
+        if (m1.selection != 1) // Hall 또는 Both 선택 (Both = Hall 측정 + 게이트 엣지)
+        {
+            measureSourceMode = 5; // 나중을 위해 기록
+            enterMode(2); // Hall Calibration으로 이동
+        } 
+        else if (!passSensorOk()) // 포토 전용: 각도 보정 없이 바로 측정
+        {
+            measureSourceMode = 3;
+            enterMode(3);
+        }
+        else // Photo 선택
+        {
+            measureSourceMode = 3; // 나중을 위해 기록
+            enterMode(2); // Photo도 각도 확인 위해 Hall Calib 먼저 수행
+        }
+      }
+      break;
+    }
+    
+    // ======================================================
+    // Mode 2: Hall Sensor Calibration (0점 잡기)
+    // ======================================================
+    case 2: 
+    {
+      // [추가] 측정 중 AS5600이 사라지면 (복구는 I2cBus가 백그라운드에서 계속 시도)
+      if (!passSensorOk()) {
+        lcd.setCursor(0, 1); lcd.print(F("Sensor lost! B:<"));
+        if (B_pressed) { enterMode(1); }
+        break;
+      }
+
+      int rawAngle = passIn.angle;
+      float currentAngle = (float)rawAngle * 360.0 / 4096.0;
+
+      if (m2.step == 0) // 대기
+      {
+        lcd.setCursor(0, 1);
+        lcd.print(F("Raw: ")); lcd.print(currentAngle, 2); lcd.print(F("   "));
+
+        if (A_pressed) {
+          m2.step = 1; 
+          m2.stableStartTime = passIn.ms; 
+          m2.lastStableValue = currentAngle; 
+          lcd.setCursor(0, 1); lcd.print(F("Waiting static..."));
+        }
+        if (B_pressed) {
+          enterMode(1);
+        }
+      }
+      else if (m2.step == 1) // 안정화 감지
+      {
+        int currentIntAngle = (int)currentAngle;
+        int lastIntAngle = (int)m2.lastStableValue;
+
+        if (currentIntAngle != lastIntAngle) {
+          m2.stableStartTime = passIn.ms; 
+          m2.lastStableValue = currentAngle; 
+        }
+
+        if (passIn.ms - m2.stableStartTime > 2000) {
+          angleOffset = currentAngle; 
+          m2.step = 2; 
+          lcd.setCursor(0, 1); lcd.print(F("Calibrated!     "));
+          holdMs(1000); 
+        }
+      }
+      else if (m2.step == 2) // 확인
+      {
+        float calibratedAngle = currentAngle - angleOffset;
+        if (calibratedAngle > 180.0) calibratedAngle -= 360.0;
+        else if (calibratedAngle < -180.0) calibratedAngle += 360.0;
+        
+        lcd.setCursor(0, 1);
+        lcd.print(F("Angle: "));
+        if (calibratedAngle > 0) lcd.print(F("+")); 
+        lcd.print(calibratedAngle, 2); lcd.print(F(" deg   "));
+
+        if (A_pressed) {
+          // 측정 모드에 따라 분기
+          if (measureSourceMode == 5) enterMode(5); // Hall Measure
+          else                        enterMode(3); // Photo Measure
+        }
+        if (B_pressed) {
+          enterMode(1);
+        }
+      }
+      break; 
+    }
+
+    // ======================================================
+    // Mode 3: Photo Interrupter Measure (신규 구현)
+    // ======================================================
+    case 3: 
+    {       
+      // --- 각도 계산 (AS5600 사용 - 초기 위치 잡기용) ---
+      int rawAngle = passIn.angle;
+      float currentAngle = (float)rawAngle * 360.0 / 4096.0;
+      float calibratedAngle = currentAngle - angleOffset;
+      if (calibratedAngle > 180.0) calibratedAngle -= 360.0;
+      else if (calibratedAngle < -180.0) calibratedAngle += 360.0;
+      float absAngle = fabs(calibratedAngle);
+
+      // --- Step 0: 각도 맞추기 (Mode 5와 동일 로직) ---
+      if (m3.step == 0 && !passSensorOk()) // [추가] 포토 전용: 각도 확인 없이 A로 시작
+      {
+         lcd.setCursor(0, 1); lcd.print(F("A: start        "));
+         if (A_pressed) {
+            m3.step = 1;
+            m3.countdown = 3;
+            m3.prevTime = passIn.ms;
+            lcd.clear();
+         }
+      }
+      else if (m3.step == 0)
+      {
+         float diff = fabs(SetAngle - absAngle);
+         
+         lcd.setCursor(0, 1);
+         lcd.print(F("Go to: ")); lcd.print(SetAngle, 1);
+         lcd.print(F(" (")); lcd.print(absAngle, 1); lcd.print(F(") "));
+
+         if (diff < DET_GOTO_TOL_DEG) 
+         {
+            if (m3.stableStartTime == 0) m3.stableStartTime = passIn.ms;
+            if (passIn.ms - m3.stableStartTime > DET_GOTO_HOLD_MS) 
+            {
+               m3.step = 1; // 카운트다운 진입
+               m3.countdown = 3;
+               m3.prevTime = passIn.ms;
+               buzzer.play(1500, 100); 
+               lcd.clear();
+            }
+         }
+         else { m3.stableStartTime = 0; }
+      }
+
+      // --- Step 1: 카운트다운 ---
+      else if (m3.step == 1)
+      {
+         lcd.setCursor(0, 0); lcd.print(F("== Ready? =="));
+         lcd.setCursor(0, 1); lcd.print(F("Start in ")); lcd.print(m3.countdown); lcd.print(F("...    "));
+
+         if (passIn.ms - m3.prevTime >= 1000) 
+         {
+            m3.countdown--;
+            m3.prevTime = passIn.ms;
+            if (m3.countdown > 0) {
+               buzzer.play(800, 100); 
+            } else {
+               buzzer.play(2500, 600); 
+               // 측정 시작 초기화
+               m3.step = 2; 
+               m3.hitCount = 0;
+               m3.timerStart = 0; 
+               m3.peakAmp = 0;
+               runLog.clear();
+               runDecay.reset();
+               m3.lastPhotoState = passPhoto() ? HIGH : LOW; // 초기 상태 읽기
+               
+               lcd.clear();
+               lcd.setCursor(0, 0); lcd.print(F("Release!"));
+               lcd.setCursor(0, 1); lcd.print(F("Waiting sensor.."));
+            }
+         }
+      }
+
+      // --- Step 2: 측정 (포토 인터럽터) ---
+      else if (m3.step == 2)
+      {
+          int photoState = passPhoto() ? HIGH : LOW;
+          uint32_t now = passIn.ms;
+
+          // [추가] 통과 사이 최대 각도 = 이번 반주기 진폭 (진폭 보정용)
+          if (passSensorOk() && passMagnetOk() && absAngle > m3.peakAmp) m3.peakAmp = absAngle;
+
+          // 엣지 감지: 막힘 (Beam Broken, 보통 LOW)
+          // PHOTO_PIN이 평소 HIGH(Pullup)이고 막히면 LOW라고 가정 (일반적 BUP-50S 등)
+          // photo_final.cpp 로직 참조: HIGH -> LOW 일 때 blockActive
+          if (m3.lastPhotoState == HIGH && photoState == LOW) 
+          {
+             // 디바운싱: 너무 빠른 연속 감지 방지 (DET_PHOTO_DEBOUNCE_MS, 기본 50ms)
+             if (now - m3.lastHitMs > DET_PHOTO_DEBOUNCE_MS) 
+             {
+                 runLog.append(passIn.us);
+                 if (m3.hitCount >= 1 && m3.peakAmp > 0) runDecay.add(m3.peakAmp); // 첫 통과 전은 놓는 구간
+                 m3.peakAmp = 0;
+                 m3.hitCount++;
+                 m3.lastHitMs = now;
+                 buzzer.play(1200, 50); // 짧은 삑
+
+                 // === 로직 설명 ===
+                 // Hit 1: 첫 번째 통과 (최저점). 타이머 시작.
+                 // Hit 2: 반대편 갔다가 돌아옴 (1/2 주기) -> 진자 1회 통과
+                 // Hit 3: 다시 원래 방향 (1 주기 완료) -> 진자 2회 통과
+                 // ...
+                 // 우리는 'swing'번의 왕복을 측정하고 싶음.
+                 // 1회 왕복 = 2번의 통과 (왔다 갔다)
+                 // 따라서 swing * 2 번의 추가 통과가 필요함.
+                 // 시작점(Hit 1)을 0초로 잡으면, Hit (1 + swing*2) 에서 멈춰야 함.
+                 
+                 if (m3.hitCount == 1) 
+                 {
+                     m3.timerStart = now;
+                     lcd.clear();
+                     lcd.setCursor(0, 0);
+                     lcd.print(F("Measuring..."));
+                 }
+                 else 
+                 {
+                     // 진행 상황 표시 (왕복 횟수)
+                     int currentRoundTrip = (m3.hitCount - 1) / 2;
+                     lcd.setCursor(0, 1);
+                     lcd.print(F("Count: ")); lcd.print(currentRoundTrip); 
+                     lcd.print(F("/")); lcd.print(swing);
+
+                     // 종료 조건: 목표 왕복 횟수 채움
+                     if (m3.hitCount >= (1 + swing * 2)) 
+                     {
+                         m3.step = 3;
+                         buzzer.play(2000, 800);
+                         printSwingPeriods(runLog);
+                         printAmpCorrection(0.5);
+                         if (runDecay.count() > 0) printDecay();
+                     }
+                 }
+             }
+          }
+          m3.lastPhotoState = photoState;
+      }
+
+      // --- Step 3: 결과 표시 ---
+      else if (m3.step == 3)
+      {
+          // 계산
+          if (m3.timerStart > 0) {
+              // [변경] 로그의 첫/마지막 통과 시각(us)으로 계산
+              float totalTimeSec = runLogSpanSec();
+              time_s = smallAnglePeriod(0.5); // [변경] 왕복별 진폭 보정한 평균 주기 (작은 각 기준)
+
+              lcd.clear();
+              lcd.setCursor(0, 0); lcd.print(F("T0: ")); lcd.print(time_s, 4); lcd.print(F("s"));
+              lcd.setCursor(0, 1); lcd.print(F("Tot: ")); lcd.print(totalTimeSec, 2); lcd.print(F("s"));
+
+              m3.timerStart = 0; // 플래그 리셋하여 계산 1회만 수행
+          }
+
+          // A버튼: 다음(입력 모드)
+          if (A_pressed) {
+              enterMode(4); // 입력 모드로
+          }
+          // B버튼: 재측정
+          if (B_pressed) {
+              enterMode(3);
+              break; // 아래 "측정 도중 B" 처리로 넘어가지 않게
+          }
+      }
+
+      // 측정 도중(Step 0~2) B버튼 누르면 설정 취소
+      if (m3.step < 3 && B_pressed) {
+          enterMode(passSensorOk() ? 2 : 1); // 다시 Calib 화면이나 모드 선택으로
+      }
+      break;
+    }
+
+    // ======================================================
+    // Mode 4: Input Variables (Mass & Distance)
+    // ======================================================
+    case 4:
+    {
+      const __FlashStringHelper* title;
+      if (m4.editingStep == 0) title = F("Set Mass (kg)");
+      else                     title = F("Set Dist. (m)");
+
+      if (m4.isInputDone) 
+      {
+        if (m4.editingStep == 0) { // Mass 완료
+          mass_kg = mode4_getFinalValue(m4.digits); 
+          m4.editingStep = 1; 
+          mode4_resetInput(m4.digits, m4.currentDigitPosition, m4.lastMappedDigit, m4.isInputDone); 
+          mode4_updateLcd(F("Set Dist. (m)"), m4.digits, m4.currentDigitPosition, m4.isInputDone); 
+        } 
+        else { // Distance 완료 -> 결과 계산 모드(6)로
+          distance_m = mode4_getFinalValue(m4.digits); 
+          
+          enterMode(6); 
+        }
+      }
+      else 
+      {
+        int newDigit = m4.digitQ.update(passIn.pot);
+
+        if (newDigit != m4.lastMappedDigit) {
+            m4.digits[m4.currentDigitPosition] = newDigit;
+            if (m4.lastMappedDigit < 0) mode4_updateLcd(title, m4.digits, m4.currentDigitPosition, m4.isInputDone); // 진입/자리 이동
+            else                        mode4_updateDigits(m4.digits);                                                  // 숫자만 변경
+            m4.lastMappedDigit = newDigit;
+        }
+
+        if (A_pressed) {
+            m4.currentDigitPosition++;
+            m4.lastMappedDigit = -1; 
+            if (m4.currentDigitPosition >= 6) m4.isInputDone = true; 
+            else mode4_updateLcd(title, m4.digits, m4.currentDigitPosition, m4.isInputDone); 
+        }
+
+        if (B_pressed) {
+            if (m4.currentDigitPosition > 0) {
+                m4.currentDigitPosition--;
+                m4.lastMappedDigit = -1; 
+                mode4_updateLcd(title, m4.digits, m4.currentDigitPosition, m4.isInputDone);
+            }
+            else {
+                // [탈출 로직 수정] 이전 단계나 측정 모드로 복귀
+                if (m4.editingStep == 1) { // Distance -> Mass
+                    m4.editingStep = 0; 
+                    mode4_resetInput(m4.digits, m4.currentDigitPosition, m4.lastMappedDigit, m4.isInputDone);
+                    mode4_updateLcd(F("Set Mass (kg)"), m4.digits, m4.currentDigitPosition, m4.isInputDone);
+                }
+                else { // Mass -> 측정 모드(Photo or Hall)로 복귀
+                    // 바로 재측정 대기 상태(step 0)로
+                    enterMode(measureSourceMode); // 3 or 5
+                }
+            }
+        }
+      }
+      break;
+    }
+   
+    // ======================================================
+    // Mode 5: Hall Sensor Measure (기존 유지)
+    // ======================================================
+    case 5: 
+    {
+      // [추가] 측정 중 AS5600이 사라지면 (복구는 I2cBus가 백그라운드에서 계속 시도)
+      if (!passSensorOk()) {
+        lcd.setCursor(0, 1); lcd.print(F("Sensor lost! B:<"));
+        if (B_pressed) { enterMode(1); }
+        break;
+      }
+
+      int rawAngle = passIn.angle;
+      float currentAngle = (float)rawAngle * 360.0 / 4096.0;
+      float calibratedAngle = currentAngle - angleOffset;
+      if (calibratedAngle > 180.0) calibratedAngle -= 360.0;
+      else if (calibratedAngle < -180.0) calibratedAngle += 360.0;
+      float absAngle = fabs(calibratedAngle); 
+
+      m5.filteredAbsAngle = (m5.filteredAbsAngle * DET_HALL_EMA_OLD) + (absAngle * (1.0 - DET_HALL_EMA_OLD));
+      int currentIntAngle = (int)m5.filteredAbsAngle;
+
+      // --- Step 0 ---
+      if (m5.step == 0)
+      {
+         if (m5.stableStartTime == 0) { m5.filteredAbsAngle = absAngle; }
+         float diff = fabs(SetAngle - m5.filteredAbsAngle);
+         lcd.setCursor(0, 1);
+         lcd.print(F("Go to: ")); lcd.print(SetAngle, 1);
+         lcd.print(F(" (")); lcd.print(m5.filteredAbsAngle, 1); lcd.print(F(")  ")); 
+
+         if (diff < DET_GOTO_TOL_DEG) {
+            if (m5.stableStartTime == 0) m5.stableStartTime = passIn.ms;
+            if (passIn.ms - m5.stableStartTime > DET_GOTO_HOLD_MS) {
+               m5.step = 1; 
+               m5.countdown = 3;
+               m5.prevTime = passIn.ms;
+               buzzer.play(1500, 100); 
+               lcd.clear();
+            }
+         }
+         else { m5.stableStartTime = 0; }
+      }
+      // --- Step 1 ---
+      else if (m5.step == 1)
+      {
+         lcd.setCursor(0, 0); lcd.print(F("== Ready? =="));
+         lcd.setCursor(0, 1); lcd.print(F("Start in ")); lcd.print(m5.countdown); lcd.print(F("...    "));
+         if (passIn.ms - m5.prevTime >= 1000) {
+            m5.countdown--;
+            m5.prevTime = passIn.ms;
+            if (m5.countdown > 0) buzzer.play(800, 100); 
+            else {
+               buzzer.play(2500, 600); 
+               m5.step = 2; 
+               m5.swingCount = 0; 
+               m5.prevIntAngle = currentIntAngle; 
+               m5.readyForPeak = false; 
+               m5.timerStart = 0; 
+               runLog.clear();
+               runDecay.reset();
+               gateStats.reset();
+               resetFrequency();
+               lcd.clear(); lcd.setCursor(0, 0); lcd.print(F("Warm-up...")); 
+            }
+         }
+      }
+      // --- Step 2 ---
+      else if (m5.step == 2)
+      {
+         uint32_t currentMillis = passIn.ms;
+
+         // [추가] Hall+Photo: 시작 피크 이후 게이트 엣지를 따로 쌓음 (홀 검출과 독립)
+         if (fusedRun && (passIn.flags & IN_GATE) && !runLog.empty()
+             && (int32_t)(passIn.gateUs - runLog.first()) >= 0) gateStats.add(passIn.gateUs);
+
+         // [추가] 자석 상태 불량이면 각도가 쓰레기 → 피크로 세지 않고 다음 최저점부터 다시
+         bool magnetOk = passMagnetOk();
+         if (!magnetOk) {
+             m5.readyForPeak = false;
+             lcd.setCursor(12, 0); lcd.print(F("MAG!"));
+         }
+         else { lcd.setCursor(12, 0); lcd.print(F("    ")); }
+
+         if (magnetOk && currentIntAngle < DET_HALL_ARM_DEG) { m5.readyForPeak = true; m5.peakAmp = 0; }
+         if (magnetOk && m5.readyForPeak && m5.filteredAbsAngle > m5.peakAmp) m5.peakAmp = m5.filteredAbsAngle;
+         
+         if (m5.readyForPeak && (m5.prevIntAngle > currentIntAngle) && (m5.prevIntAngle > DET_HALL_PEAK_DEG))
+         {
+             m5.swingCount++; 
+             m5.readyForPeak = false; 
+             buzzer.play(1000, 50); 
+
+             if (m5.swingCount >= 2) { // 시작 피크부터 기록
+                 runLog.append(passIn.us);
+                 runDecay.add(m5.peakAmp);
+             }
+
+             if (m5.swingCount == 2) {
+                 m5.timerStart = passIn.ms; 
+                 lcd.clear(); lcd.setCursor(0, 0); lcd.print(F("Start! 0/")); lcd.print(swing);
+                 buzzer.play(1500, 200); 
+             }
+             else if (m5.swingCount > 2) {
+                 int validPeaks = m5.swingCount - 2;
+                 if (validPeaks % 2 == 0) {
+                     int validRoundTrip = validPeaks / 2;
+                     lcd.setCursor(0, 0);
+                     lcd.print(F("Count: ")); lcd.print(validRoundTrip); lcd.print(F("/")); lcd.print(swing);
+                     // [추가] 다음 왕복 피크가 검출 임계 근처까지 줄어들 것으로 예측되면
+                     //        (더 기다려도 놓치기만 함) 지금까지 왕복으로 끝냄
+                     bool done = validRoundTrip >= swing;
+                     if (!done && validRoundTrip >= MIN_SWINGS && runDecay.ready()
+                         && runDecay.swingsLeft(DET_HALL_PEAK_DEG + 1) < 1.0) done = true;
+                     if (done) {
+                         m5.step = 3; 
+                         buzzer.play(2000, 1000); 
+                         lcd.clear();
+                         printSwingPeriods(runLog);
+                         printAmpCorrection(1.0);
+                         printDecay();
+                         printTrack();
+                         if (fusedRun) printFusion();
+                     }
+                 }
+             }
+         }
+         m5.prevIntAngle = currentIntAngle;
+
+         if (m5.timerStart > 0) {
+             float totalElapsed = (currentMillis - m5.timerStart) / 1000.0;
+             lcd.setCursor(0, 1); lcd.print(F("t:")); lcd.print(totalElapsed, 1);
+             // [추가] 스트림 주기 추정 (칸마다 갱신)
+             lcd.print(F("s T~"));
+             if (freqTracker.periodUs() > 0) lcd.print(clockCal.toSec(freqTracker.periodUs()), 3);
+             else                            lcd.print(F("-    "));
+             lcd.print(F("  "));
+         }
+      }
+      // --- Step 3 ---
+      else if (m5.step == 3)
+      {
+          if (m5.timerStart > 0) { 
+              // [변경] 루프 도착 시각 대신 로그의 시작/마지막 피크 시각(us)으로 계산
+              float totalTimeSec = runLogSpanSec();
+              time_s = smallAnglePeriod(1.0); // [변경] 왕복별 진폭 보정 (조기 종료면 swing보다 적은 왕복)
+
+              // [추가] Hall+Photo: 합친 주기에 홀 쪽 진폭 보정 비율을 그대로 곱함
+              FusedPeriod f;
+              bool fused = fusedPeriod(f);
+              if (fused) time_s *= f.T / (totalTimeSec / runLogSwings());
+
+              lcd.setCursor(0, 0); lcd.print(F("T0: ")); lcd.print(time_s, 4); lcd.print(F(" s"));
+              lcd.setCursor(0, 1); lcd.print(F("Tot:")); lcd.print(totalTimeSec, 2); lcd.print(F("s"));
+              if (!fusedRun)         { lcd.print(F(" Q:")); lcd.print((int)runDecay.qFactor()); } // [추가]
+              else if (!fused)       lcd.print(F(" HP:--")); // 게이트 왕복 부족
+              else if (f.disagree)   lcd.print(F(" HP:!!")); // 두 센서가 불확도 이상으로 어긋남
+              else                   lcd.print(F(" HP:ok"));
+              m5.timerStart = 0; 
+          }
+          if (A_pressed) {
+              enterMode(4); // 입력 모드로
+          }
+          if (B_pressed) {
+            enterMode(5); break; // 아래 "Step 0~2에서 B" 처리로 넘어가지 않게
+          }
+      }
+      // Step 0~2에서 B 누르면
+      if (m5.step < 3 && B_pressed) {
+          enterMode(2);
+      }
+      break;
+    }
+
+    // ======================================================
+    // Mode 6: Calculation Result
+    // ======================================================
+    case 6:
+    {
+      float I_value = inertiaValue();
+
+      lcd.setCursor(0, 0);
+      lcd.print(F("I=")); lcd.print(I_value, 5); lcd.print(F(" kgm^2 "));
+
+      // [변경] 2번째 줄에 1차 불확도 (1 sigma) + 버튼 안내 축약
+      lcd.setCursor(0, 1);
+      lcd.print(F("+-")); lcd.print(inertiaSigma(), 5); lcd.print(F(" A:R B<  "));
+
+      if (A_pressed) {
+        enterMode(0); // 완전 초기화
+      }
+      if (B_pressed) {
+        // [수정] 측정했던 모드로 돌아가기
+        // 결과 화면 상태(step 3)로 복귀
+        enterMode(measureSourceMode, 3); 
+      }
+      break;
+    }
+  }
+}
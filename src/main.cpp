@@ -1,764 +1,415 @@
 #include <Arduino.h>
-#include <LiquidCrystal_I2C.h>
 #include <Wire.h>
 #include <math.h> 
-#include <AS5600.h>
+#include "As5600Lean.h"
+#include "Pins.h"
+#include "ButtonScanner.h"
+#include "Buzzer.h"
+#include "AdcEngine.h"
+#include "AngleSource.h"
+#include "ShadowLcd.h"
+#include "I2cBus.h"
+#include "Bench.h"
+#include "GateRig.h"
+#include "MemStats.h"
+#include "EventLog.h"
+#include "LoopStats.h"
+#include "SessionRecord.h"
+#include "GateCapture.h"
+#include "DetectorParams.h" // [추가] 검출 임계값 (tools/tune_detector.py 생성)
+#include "StateMachine.h" // [추가] 모드 0~6 상태 머신 (재생 호스트와 같이 씀)
 
-// ==================== 핀 설정 ====================
-#define BUTTON_A_PIN 2
-#define BUTTON_B_PIN 3
-#define BUZZER_PIN 9
-#define POT_PIN A1
-#define PHOTO_PIN 5       // [추가] 포토 인터럽터 핀 (기존 4번은 AS5600 충돌 가능성으로 5번 권장)
+// ==================== 객체 생성 ====================
+ShadowLcd lcd(0x27, 16, 2); // [변경] 섀도 버퍼 - 실제 전송은 I2cBus가 센서 읽기 사이에
+As5600Lean as5600(Wire); // [변경] RAW ANGLE 포인터 파킹 + 주기적 자석 상태 확인
+
+// [추가] loop() 패스 시간 계측 (-DLOOP_STATS 빌드에서만 동작)
+// 슬롯: 모드마다 1칸, 스텝이 있는 모드(2, 3, 5)는 스텝마다 1칸
+const uint8_t LOOP_SLOT_BASE[7]  = { 0, 1, 2, 5, 9, 10, 14 };
+const uint8_t LOOP_SLOT_STEPS[7] = { 1, 1, 3, 4, 1, 4,  1 };
+LoopStats<15> loopStats;
+
+// [추가] 패스 입력 스냅샷 (passIn, StateMachine.cpp): 상태 머신은 millis()/micros()/핀/센서를 직접 보지 않고 이것만 봄
+// (기록한 스냅샷을 그대로 다시 넣으면 같은 결과 → 재생 가능)
+PassInputs prevIn;          // 직전 패스 (기록 여부 판단용)
+PassInputs recLast;         // 직전 기록 줄 (d 줄은 이것과의 차이)
+bool recording = false;     // Serial 'R' 시작 / 'r' 끝
+bool recHasBase = false;    // 기록 시작 뒤 첫 줄(절대값 r 줄)을 냈는지
+bool traceOn = false;       // [추가] Serial 'T' 켬 / 't' 끔: Mode 5 측정 중 각도 샘플을 t 줄로
+uint32_t traceLastUs = 0;
+#define TRACE_EVERY_US 4000 // 내보내는 샘플 간격 (250Hz ≈ 4.5kB/s, 115200bps의 절반 아래)
+uint16_t lastStateCrc = 0;
+#ifdef REPLAY
+session::LineReader replayLine;
+bool replayHasHash = false; // 이번 줄에 기록한 상태 지문이 있었는지
+uint16_t replayHash;
+#else
+// [추가] 'K' 뒤 보정값 줄: handleSerial이 막지 않고 모아서 읽음 (CLOCK_ENTRY_MS 안에 줄이 안 끝나면 버림)
+session::LineReader clockLine;
+bool clockEntry = false;
+uint32_t clockEntryMs = 0;
+#define CLOCK_ENTRY_MS 200
+#endif
+
+// ==================== 버튼 (Timer0 COMPB 틱에서 일괄 디바운싱) ====================
+// 10틱(≈10ms)마다 PIND 한 번 읽기, 롱프레스 100스캔(≈1s)
+ButtonScanner<10, 100, BUTTON_A_PIN, BUTTON_B_PIN> buttons;
+
+// [추가] 포토 게이트 빔 차단 엣지를 핀 변화 인터럽트로 캡처 (D5 = PCINT21, 포트 D 그룹)
+GateCapture<PHOTO_PIN> gate;
+static_assert(pinmap::port(PHOTO_PIN) == pinmap::PORT_ID_D, "PCINT2_vect below assumes the photo pin is on port D");
+
+// [변경] tone() 대신 Timer1 하드웨어 PWM + 큐 (측정 중 추가 인터럽트 없음)
+BuzzerSequencer buzzer;
+
+// [변경] analogRead() 대신 free-running ADC
+//   AS5600 OUT: 슬롯 3/4 (≈7.2kHz, 평균/필터 없음 - 0/360도 경계에서 평균 내면 안 됨), 아날로그 각도 경로일 때만
+//   팟       : 슬롯 1/4, 16배 오버샘플 + IIR 1/4 (I2C 경로면 팟만 남아 Timer0 오버플로로 ≈1kHz → 61Hz 값)
+#define ANGLE_ADC_WEIGHT 3
+AdcEngine adc;
+uint8_t angleCh;
+uint8_t potCh;
+
+// [추가] 각도 소스 (I2C readAngle 또는 AS5600 OUT 아날로그), 같은 샘플 스트림을 냄
+AngleSource angleSource(as5600);
+
+// I2C 경로에서는 아무도 안 읽는 A0 변환으로 측정 중 ADC ISR을 9.6kHz로 돌리지 않음
+void selectAngleSource(AngleSource::Kind k)
+{
+  angleSource.select(k);
+  adc.setWeight(angleCh, k == AngleSource::SRC_ANALOG ? ANGLE_ADC_WEIGHT : 0);
+}
 
-#define swing 10          // 측정할 왕복 횟수
+// [추가] AS5600(1ms 주기, 우선) / LCD(남는 시간에 한 글자씩) 버스 스케줄러 + 행 복구
+I2cBus bus(angleSource, as5600, lcd, 1000);
 
-// ==================== 객체 생성 ====================
-LiquidCrystal_I2C lcd(0x27, 16, 2);
-AS5600 as5600(&Wire); 
+// Timer0은 millis()용으로 이미 돌고 있으므로 COMPB만 켜서 1.024ms 틱으로 씀
+ISR(TIMER0_COMPB_vect)
+{
+  buttons.tick();
+  buzzer.tick();
+}
 
-// ==================== 전역 변수 ====================
-int mode = 0;
-int measureSourceMode = 5; // [추가] 측정 모드가 어디였는지 기억 (3=Photo, 5=Hall)
+ISR(ADC_vect)
+{
+  if (adc.isr() == angleCh) angleSource.pushSample(adc.value(angleCh));
+}
 
-// 모드 0에서 입력할 초기 스윙 시작 각도
-float SetAngle = 0.0;
+#ifndef MULTI_GATE // 다중 게이트 빌드는 GateRig.cpp가 같은 벡터를 씀
+ISR(PCINT2_vect)
+{
+  gate.isr();
+}
+#endif
 
-// 관성모멘트 계산 물리량
-float mass_kg = 0.0;     
-float distance_m = 0.0;  
-float time_s = 0.0;      // 측정된 주기(T)
+// ==================== 함수 정의 ====================
 
-// ==================== 클래스 정의 ====================
-class DebouncedButton 
+// [추가] 쌓인 각도 샘플을 0점 기준 부호 있는 값으로 주기 추적기에 넣음
+// (I2C 경로 1kHz면 큐 32칸 = 32ms 분량. 7.2kHz 아날로그 경로는 패스가 길면 일부 샘플이 버려짐)
+void trackFrequency() 
 {
-    private:
-        uint8_t _pin;
-        unsigned long _debounceDelay;
-        unsigned long _lastDebounceTime;
-        int _buttonState;
-        int _lastButtonState;
-
-        uint8_t _buzzerPin;
-        int _buzzerTone;
-        int _buzzerDuration;
-
-    public:
-        DebouncedButton(uint8_t pin) 
-        {
-            _pin = pin;
-            _debounceDelay = 50;
-            _lastDebounceTime = 0;
-            _buttonState = HIGH;
-            _lastButtonState = HIGH;
-            _buzzerPin = 0;
-            _buzzerTone = 0;
-            _buzzerDuration = 0;
-        }
-
-    void begin() 
-    {
-        pinMode(_pin, INPUT_PULLUP);
+  int16_t offset = (int16_t)(angleOffset * 4096.0 / 360.0);
+  AngleSample s;
+  while (angleSource.pop(s)) {
+    if (traceOn && s.tUs - traceLastUs >= TRACE_EVERY_US) {
+      Serial.print(F("t,")); Serial.print(s.tUs); Serial.print(','); Serial.println(s.raw);
+      traceLastUs = s.tUs;
     }
+    int16_t c = (int16_t)s.raw - offset;
+    if (c >= 2048) c -= 4096;
+    else if (c < -2048) c += 4096;
+    freqTracker.push(s.tUs, c);
+  }
+}
 
-    void attachBuzzer(uint8_t pin, int tone, int duration) 
-    {
-        _buzzerPin = pin;
-        _buzzerTone = tone;
-        _buzzerDuration = duration;
-        pinMode(_buzzerPin, OUTPUT);
-    }
+// 측정 시작: 추적기 초기화 + 측정 전에 쌓여 있던 샘플 버림
+// 샘플 내보내기가 켜져 있으면 "trace,begin,<0점 raw>" (끝은 printTrack 뒤 "trace,end")
+void resetFrequency() 
+{
+  freqTracker.reset();
+  AngleSample s;
+  while (angleSource.pop(s)) { }
+  if (traceOn) {
+    Serial.print(F("trace,begin,")); Serial.println((int)(angleOffset * 4096.0 / 360.0));
+    traceLastUs = micros() - TRACE_EVERY_US;
+  }
+}
 
-    bool checkPressed() 
-    {
-        bool pressedEvent = false;
-        int reading = digitalRead(_pin);
-
-        if (reading != _lastButtonState)
-        {
-            _lastDebounceTime = millis();
-        }
-
-        if ((millis() - _lastDebounceTime) > _debounceDelay) 
-        {
-            if (reading != _buttonState) 
-            {
-                _buttonState = reading;
-                
-                if (_buttonState == LOW) 
-                {
-                    pressedEvent = true; 
-                    if (_buzzerPin != 0) 
-                    {
-                        tone(_buzzerPin, _buzzerTone, _buzzerDuration);
-                    }
-                }
-            }
-        }
-        _lastButtonState = reading;
-        return pressedEvent;
-    }
-};
+// 스트림 주기 결과: "track,<전체 스트림 T>,<최근 창 T>,<갱신 칸 수>,<버린 샘플 수>"
+void printTrack() 
+{
+  Serial.print(F("track,")); Serial.print(clockCal.toSec(freqTracker.runPeriodUs()), 6);
+  Serial.print(','); Serial.print(clockCal.toSec(freqTracker.periodUs()), 6);
+  Serial.print(','); Serial.print(freqTracker.updates());
+  Serial.print(','); Serial.println(angleSource.dropped());
+  if (traceOn) Serial.println(F("trace,end"));
+}
+
+// 패스 마감 시간: 측정 중에는 센서를 놓치지 않게 짧게
+uint32_t loopDeadlineUs(int m, int step) 
+{
+  if (m == 3 && step == 2) return 2000;  // 포토 게이트 폴링 (빔 차단 펄스 수 ms)
+  if (m == 5 && step == 2) return 20000; // 피크 검출용 각도 샘플 간격
+  return 30000;                          // UI: bus.wait(10) + LCD
+}
 
-DebouncedButton* buttonA;
-DebouncedButton* buttonB;
+void markLoop() 
+{
+  int step = currentStep();
+  int last = LOOP_SLOT_STEPS[mode] - 1;
+  uint8_t slot = LOOP_SLOT_BASE[mode] + (step < last ? step : last);
+  loopStats.mark(slot, mode, step, loopDeadlineUs(mode, step));
+}
 
-// ==================== 함수 정의 ====================
+// [추가] 시간 기준 보정값: "clk,<ppm>"
+void printClock() 
+{
+  Serial.print(F("clk,")); Serial.println(clockCal.ppm(), 2);
+}
 
-// 모드 변경 시 LCD 초기화 함수
-void updateLcdDisplay() 
+// Serial 한 글자 명령
+//   'A' : 각도 소스 = AS5600 OUT 아날로그 (ADC)
+//   'I' : 각도 소스 = I2C
+//   'H' : I2C 센서 대기시간 히스토그램 출력, 'h' : 초기화
+//   'M' : RAM 사용량 / 스택 최고 수위 (+ 측정 로그 이벤트 수, 사용 바이트, 크기)
+//   'L' : 모드/스텝별 loop() 시간 (최소/평균/최대 us, 마감 초과 횟수), 'l' : 초기화
+//   'R' : 세션 기록 시작 (처음 상태로 돌아가 "rec,begin" 후 패스 입력을 r 줄 하나 + d 줄로), 'r' : 기록 끝
+//   'T' : Mode 5 측정 중 각도 샘플 내보내기 "t,<us>,<raw>" (tools/damped_fit.py 입력), 't' : 끔
+//   'S' : 시각 맞추기 "sync,<micros>" (받자마자 micros(), tools/clock_cal.py가 측정하지 않을 때 몇 분 동안 보냄)
+//   'K<ppm>\n' : 시간 기준 보정값 저장 (EEPROM) → "clk,<ppm>" (비었거나 숫자가 아니거나 범위 밖이면 "clk,err", 저장값 그대로)
+//   'C' : 시간 기준 보정 지움 (0 ppm), 'k' : 지금 값   ('K'/'C'는 재생 빌드에서 무시: 기록의 값을 씀)
+void handleSerialCommand(char c) 
 {
-  lcd.clear(); 
-  lcd.setCursor(0, 0); 
+  switch (c) 
+  {
+    case 'A': selectAngleSource(AngleSource::SRC_ANALOG); Serial.println(F("angle source: ADC")); break;
+    case 'I': selectAngleSource(AngleSource::SRC_I2C);    Serial.println(F("angle source: I2C")); break;
+    case 'H': bus.printStats(Serial); break;
+    case 'h': bus.resetStats(); break;
+    case 'L': loopStats.print(Serial); break;
+    case 'l': loopStats.reset(); break;
+    case 'R':
+      resetSession();
+      Serial.println(F("rec,begin"));
+      printClock(); // [추가] 재생할 때 같은 보정값을 쓰도록
+      recording = true;
+      recHasBase = false;  // 첫 줄은 절대값 r 줄
+      prevIn.flags = 0xFF; // 첫 패스는 무조건 기록
+      break;
+    case 'r':
+      recording = false;
+      Serial.println(F("rec,end"));
+      break;
+    case 'T': traceOn = true;  Serial.println(F("trace: on"));  break;
+    case 't': traceOn = false; Serial.println(F("trace: off")); break;
+    case 'S':
+    {
+      uint32_t t = micros();
+      Serial.print(F("sync,")); Serial.println(t);
+      break;
+    }
+#ifndef REPLAY
+    case 'K': // 숫자 줄은 handleSerial()이 이어서 읽음
+      clockLine.reset();
+      clockEntry = true;
+      clockEntryMs = millis();
+      break;
+    case 'C': clockCal.clear(); printClock(); break;
+#endif
+    case 'k': printClock(); break;
+    case 'M':
+      memstats::print(Serial);
+      Serial.print(F("mode_state,")); Serial.println(sizeof(modeState));
+      Serial.print(F("run_log,")); Serial.print(runLog.count());
+      Serial.print(','); Serial.print(runLog.bytesUsed());
+      Serial.print(','); Serial.println(sizeof(runLog));
+      break;
+  }
+}
 
-  switch (mode) 
+#ifndef REPLAY
+void handleSerial() 
+{
+  if (clockEntry)
   {
-    case 0: lcd.print("== Set angle ==");   break;
-    case 1: lcd.print("== which mode? =="); break;
-    case 2: lcd.print("== Hall Cal. ==");   break;
-    case 3: lcd.print("== Photo Mode ==");  break; // [변경] TBD -> Photo Mode
-    case 4: lcd.print("== Set M & D ==");   break;
-    case 5: lcd.print("== Hall Mode ==");   break; 
-    case 6: lcd.print("== Inertia Cal =="); break;
+    const char* line = clockLine.poll(Serial);
+    if (line)
+    {
+      clockEntry = false;
+      if (clockCal.storeText(line)) printClock();
+      else Serial.println(F("clk,err"));
+    }
+    else if (millis() - clockEntryMs > CLOCK_ENTRY_MS)
+    {
+      clockEntry = false;
+      Serial.println(F("clk,err"));
+    }
+    return;
   }
+  if (Serial.available()) handleSerialCommand(Serial.read());
 }
 
-// Mode 4용 화면 업데이트 헬퍼
-void mode4_updateLcd(const char* title, int digits[6], int pos, bool isDone) 
+// 하드웨어에서 이번 패스 입력을 읽음 (시계도 여기서 한 번만)
+bool readInputs(PassInputs& in) 
 {
-  lcd.clear(); 
-  lcd.setCursor(0, 0); 
-  lcd.print(title);
-
-  char displayString[10];
-  sprintf(displayString, "%d%d%d%d.%d%d", 
-          digits[5], digits[4], digits[3], digits[2], digits[1], digits[0]);
-  lcd.setCursor(0, 1);
-  lcd.print(displayString);
-  lcd.print("        "); 
+  in.us = micros();
+  in.ms = millis();
+  in.angle = angleSource.latest();
+  in.pot = adc.value(potCh);
+  in.flags = 0;
+  if (PhotoPin::read())       in.flags |= IN_PHOTO;
+  if (gate.poll(in.gateUs))   in.flags |= IN_GATE; // 패스마다 엣지 1개 (통과 간격 >> 패스 간격)
+  else                        in.gateUs = 0;
+  if (bus.sensorAvailable())  in.flags |= IN_SENSOR;
+  if (as5600.magnetOk())      in.flags |= IN_MAGNET;
+
+  ButtonEvent ev;
+  while (buttons.poll(ev))
+  {
+    if (ev.type != BTN_PRESS) continue;
+    if (ev.pin == BUTTON_A_PIN) { in.flags |= IN_A; buzzer.play(1500, 100); }
+    if (ev.pin == BUTTON_B_PIN) { in.flags |= IN_B; buzzer.play(800, 100); }
+  }
+  return true;
 }
+#else
+// 재생: 입력 대신 Serial 줄 ("rec,begin" / "clk,<ppm>" / r, d 줄 / 한 글자 명령)
+void handleSerial() {}
 
-float mode4_getFinalValue(int digits[6]) {
-  float value = 0.0;
-  value += (float)digits[0] * 0.01;
-  value += (float)digits[1] * 0.1;
-  value += (float)digits[2] * 1.0;
-  value += (float)digits[3] * 10.0;
-  value += (float)digits[4] * 100.0;
-  value += (float)digits[5] * 1000.0;
-  return value;
+bool readInputs(PassInputs& in) 
+{
+  const char* line = replayLine.poll(Serial);
+  if (!line) return false;
+  if (session::parseRecord(line, in) || session::parseDelta(line, in)) // ack는 패스가 끝난 뒤 (d 줄: in = 직전 패스)
+  {
+    replayHasHash = session::parseHash(line, replayHash);
+    return true;
+  }
+
+  float ppm;
+  if (strcmp(line, "rec,begin") == 0) { resetSession(); clockCal.use(0.0); } // clk 줄이 없는 옛 기록 = 보정 없음
+  else if (strncmp(line, "clk,", 4) == 0 && ClockCal::parse(line + 4, ppm)) clockCal.use(ppm); // [추가] 기록한 보드의 값
+  else if (line[0] && !line[1])      handleSerialCommand(line[0]);
+  Serial.println(F("ack"));
+  return false;
 }
+#endif
 
-void mode4_resetInput(int digits[6], int& pos, int& lastDigit, bool& isDone) {
-  for (int i = 0; i < 6; i++) {
-    digits[i] = 0;
+// 패스 끝: 기록 중이면 입력이나 상태가 바뀐 패스를 r/d 줄로
+void finishPass() 
+{
+#ifdef REPLAY
+  // 기록한 상태 지문과 다르면 "crc,<기록>,<재생>" (tools/replay.py가 실패로 셈)
+  uint16_t crc = stateCrc();
+  if (replayHasHash && crc != replayHash)
+  {
+    Serial.print(F("crc,")); Serial.print(replayHash, HEX);
+    Serial.print(','); Serial.println(crc, HEX);
   }
-  pos = 0; 
-  lastDigit = -1;
-  isDone = false;
+  Serial.println(F("ack"));
+#else
+  if (recording)
+  {
+    uint16_t crc = stateCrc();
+    if (session::inputsChanged(prevIn, passIn) || crc != lastStateCrc)
+    {
+      if (recHasBase) session::printDelta(Serial, recLast, passIn, crc);
+      else            session::printRecord(Serial, passIn, crc);
+      recLast = passIn;
+      recHasBase = true;
+    }
+    lastStateCrc = crc;
+  }
+  prevIn = passIn;
+#endif
+}
+
+// 화면을 보여주려고 기다리는 곳 (재생 때는 시간이 기록에서 오므로 기다리지 않음)
+void holdMs(unsigned long ms) 
+{
+#ifdef REPLAY
+  (void)ms;
+#else
+  bus.wait(ms);
+#endif
 }
 
 // ==================== SETUP ====================
 void setup() 
 {
   // 핀 설정
-  pinMode(PHOTO_PIN, INPUT_PULLUP); // [추가] 포토 인터럽터
-
-  buttonA = new DebouncedButton(BUTTON_A_PIN);
-  buttonB = new DebouncedButton(BUTTON_B_PIN);
+  PhotoPin::inputPullup(); // [추가] 포토 인터럽터
+#ifndef MULTI_GATE
+  gate.begin(DET_PHOTO_DEBOUNCE_MS * 1000UL); // [추가] 빔 차단 엣지 인터럽트 캡처
+#endif
 
-  buttonA->attachBuzzer(BUZZER_PIN, 1500, 100);
-  buttonB->attachBuzzer(BUZZER_PIN, 800, 100);
+  buttons.begin();
+  buzzer.begin();
 
-  buttonA->begin();
-  buttonB->begin();
+  angleCh = adc.addChannel(AS5600_OUT_PIN, 0, 0, angleSource.kind() == AngleSource::SRC_ANALOG ? ANGLE_ADC_WEIGHT : 0);
+  potCh   = adc.addChannel(POT_PIN, 4, 2, 1);
+  adc.begin();
+  OCR0B = 0x80;            // millis() 오버플로와 겹치지 않는 위치
+  TIMSK0 |= _BV(OCIE0B);   // 버튼 스캔 + 부저 틱 시작
 
-  Wire.begin();
+  bus.begin(); // Wire + 트랜잭션 타임아웃
   lcd.init();
   lcd.backlight();
 
-  Serial.begin(9600);
-  Serial.println("===== Serial initialization =====");
+  Serial.begin(115200); // [변경] platformio monitor_speed와 맞춤 (세션 기록 대역폭)
+  Serial.println(F("===== Serial initialization ====="));
+#ifndef REPLAY
+  clockCal.begin(); // [추가] EEPROM의 시간 기준 보정값 (재생은 기록의 clk 줄)
+#endif
+
+#ifdef MULTI_GATE
+  // [추가] 다중 게이트 측정대: AS5600 방향 핀(D4)을 출력으로 바꾸기 전에 넘어감 (돌아오지 않음)
+  lcd.print(F("Gate rig"));
+  lcd.flushAll();
+  runGateRig(clockCal);
+#endif
 
-  Serial.println("Checking for AS5600...");
+  Serial.println(F("Checking for AS5600..."));
   as5600.begin(4); // AS5600 direction pin
-  if (as5600.isConnected() == false) { 
-      Serial.println("AS5600 not detected! Check wiring.");
+  if (bus.beginSensor() == false) { 
+      // [변경] 멈추지 않고 포토 전용 모드로 진행 (센서는 백그라운드에서 계속 다시 찾음)
+      Serial.println(F("AS5600 not detected! Check wiring. Photo-only mode."));
       lcd.clear();
-      lcd.print("AS5600 ERROR");
-      while (1) delay(10); 
+      lcd.print(F("AS5600 ERROR"));
+      lcd.setCursor(0, 1);
+      lcd.print(F("Photo only"));
+      lcd.flushAll();
+      delay(1500);
+  }
+  else {
+      Serial.println(F("AS5600 found!"));
   }
-  Serial.println("AS5600 found!");
 
-  updateLcdDisplay();
+#ifdef BENCH
+  runBenchmarks();
+#endif
+
+  enterMode(0);
 }
 
 // ==================== LOOP ====================
 void loop() 
 {
-  bool A_pressed = buttonA->checkPressed();
-  bool B_pressed = buttonB->checkPressed();
+  markLoop();
+  bus.service();
+  handleSerial();
+  if (mode == 5 && modeState.m5.step == 2) trackFrequency(); // [추가]
 
-  // ----- Mode 1 (Selection) 변수 -----
-  static int mode1_selection = 0; // 0: Hall, 1: Photo
+  if (!readInputs(passIn)) return; // 재생: 다음 기록 줄이 올 때까지
 
-  // ----- Mode 2 (Hall Calib) 변수 -----
-  static int mode2_step = 0; 
-  static float angleOffset = 0.0; 
-  static unsigned long stableStartTime = 0; 
-  static float lastStableValue = -1.0;
+  runPass(); // [변경] 모드별 처리는 StateMachine.cpp (재생 호스트와 같은 코드)
   
-  // ----- Mode 3 (Photo Measure) 변수 [신규] -----
-  static int mode3_step = 0;
-  static unsigned long mode3_stableStartTime = 0;
-  static unsigned long mode3_timerStart = 0;
-  static unsigned long mode3_prevTime = 0;
-  static int mode3_countdown = 3;
-  
-  static int mode3_hitCount = 0;
-  static int mode3_lastPhotoState = HIGH;
-  static unsigned long mode3_lastHitMs = 0;
-
-  // ----- Mode 4 (Input M & D) 변수 -----
-  static int mode4_editingStep = 0; 
-  static int digits[6] = {0, 0, 0, 0, 0, 0}; 
-  static int currentDigitPosition = 0; 
-  static int lastMappedDigit = -1;     
-  static bool isInputDone = false;      
-
-  // ----- Mode 5 (Hall Measure) 변수 -----
-  static int mode5_step = 0; 
-  static unsigned long mode5_stableStartTime = 0; 
-  static unsigned long mode5_timerStart = 0;      
-  static unsigned long mode5_prevTime = 0;        
-  static int mode5_countdown = 3;                 
-  
-  static int mode5_swingCount = 0;         
-  static int mode5_prevIntAngle = 0;  
-  static bool mode5_readyForPeak = false; 
-
-  switch (mode) 
-  {
-    // ======================================================
-    // Mode 0: Set Target Angle (초기 각도 설정)
-    // ======================================================
-    case 0: 
-    {
-      float potVal = analogRead(POT_PIN);
-      float angle = map(potVal, 0, 1020, 0, 300) / 10.0;
-
-      lcd.setCursor(1, 1);
-      lcd.print(" Angle: ");
-      lcd.print(angle, 1);
-
-      if (A_pressed) 
-      {
-        mode++; // -> Mode 1
-        SetAngle = angle;
-        updateLcdDisplay();
-      }
-      break;
-    }
-
-    // ======================================================
-    // Mode 1: Select Sensor (Hall vs Photo)
-    // ======================================================
-    case 1:
-    {
-      lcd.setCursor(0, 1); 
-      if (mode1_selection == 0) lcd.print("[Hall] |  Photo ");
-      else                      lcd.print(" Hall  | [Photo] ");
-
-      // B버튼: 선택 변경
-      if (B_pressed) 
-      {
-         mode1_selection = !mode1_selection;
-      }
-
-      // A버튼: 확정
-      if (A_pressed) 
-      {
-        if (mode1_selection == 0) // Hall 선택
-        {
-            mode = 2; // Hall Calibration으로 이동
-            measureSourceMode = 5; // 나중을 위해 기록
-            mode2_step = 0;
-        } 
-        else // Photo 선택
-        {
-            mode = 2; // Photo도 각도 확인 위해 Hall Calib 먼저 수행
-            measureSourceMode = 3; // 나중을 위해 기록
-            mode2_step = 0; 
-        }
-        updateLcdDisplay();
-      }
-      break;
-    }
-    
-    // ======================================================
-    // Mode 2: Hall Sensor Calibration (0점 잡기)
-    // ======================================================
-    case 2: 
-    {
-      int rawAngle = as5600.readAngle();
-      float currentAngle = (float)rawAngle * 360.0 / 4096.0;
-
-      if (mode2_step == 0) // 대기
-      {
-        lcd.setCursor(0, 1);
-        lcd.print("Raw: "); lcd.print(currentAngle, 2); lcd.print("   ");
-
-        if (A_pressed) {
-          mode2_step = 1; 
-          stableStartTime = millis(); 
-          lastStableValue = currentAngle; 
-          lcd.setCursor(0, 1); lcd.print("Waiting static...");
-        }
-        if (B_pressed) {
-          mode = 1; updateLcdDisplay();
-        }
-      }
-      else if (mode2_step == 1) // 안정화 감지
-      {
-        int currentIntAngle = (int)currentAngle;
-        int lastIntAngle = (int)lastStableValue;
-
-        if (currentIntAngle != lastIntAngle) {
-          stableStartTime = millis(); 
-          lastStableValue = currentAngle; 
-        }
-
-        if (millis() - stableStartTime > 2000) {
-          angleOffset = currentAngle; 
-          mode2_step = 2; 
-          lcd.setCursor(0, 1); lcd.print("Calibrated!     ");
-          delay(1000); 
-        }
-      }
-      else if (mode2_step == 2) // 확인
-      {
-        float calibratedAngle = currentAngle - angleOffset;
-        if (calibratedAngle > 180.0) calibratedAngle -= 360.0;
-        else if (calibratedAngle < -180.0) calibratedAngle += 360.0;
-        
-        lcd.setCursor(0, 1);
-        lcd.print("Angle: ");
-        if (calibratedAngle > 0) lcd.print("+"); 
-        lcd.print(calibratedAngle, 2); lcd.print(" deg   ");
-
-        if (A_pressed) {
-          // 측정 모드에 따라 분기
-          if (measureSourceMode == 5) mode = 5; // Hall Measure
-          else                        mode = 3; // Photo Measure
-          updateLcdDisplay();
-        }
-        if (B_pressed) {
-          mode = 1; updateLcdDisplay();
-        }
-      }
-      break; 
-    }
-
-    // ======================================================
-    // Mode 3: Photo Interrupter Measure (신규 구현)
-    // ======================================================
-    case 3: 
-    {       
-      // --- 각도 계산 (AS5600 사용 - 초기 위치 잡기용) ---
-      int rawAngle = as5600.readAngle();
-      float currentAngle = (float)rawAngle * 360.0 / 4096.0;
-      float calibratedAngle = currentAngle - angleOffset;
-      if (calibratedAngle > 180.0) calibratedAngle -= 360.0;
-      else if (calibratedAngle < -180.0) calibratedAngle += 360.0;
-      float absAngle = fabs(calibratedAngle);
-
-      // --- Step 0: 각도 맞추기 (Mode 5와 동일 로직) ---
-      if (mode3_step == 0)
-      {
-         float diff = fabs(SetAngle - absAngle);
-         
-         lcd.setCursor(0, 1);
-         lcd.print("Go to: "); lcd.print(SetAngle, 1);
-         lcd.print(" ("); lcd.print(absAngle, 1); lcd.print(") ");
-
-         if (diff < 3.0) 
-         {
-            if (mode3_stableStartTime == 0) mode3_stableStartTime = millis();
-            if (millis() - mode3_stableStartTime > 1500) 
-            {
-               mode3_step = 1; // 카운트다운 진입
-               mode3_countdown = 3;
-               mode3_prevTime = millis();
-               tone(BUZZER_PIN, 1500, 100); 
-               lcd.clear();
-            }
-         }
-         else { mode3_stableStartTime = 0; }
-      }
-
-      // --- Step 1: 카운트다운 ---
-      else if (mode3_step == 1)
-      {
-         lcd.setCursor(0, 0); lcd.print("== Ready? ==");
-         lcd.setCursor(0, 1); lcd.print("Start in "); lcd.print(mode3_countdown); lcd.print("...    ");
-
-         if (millis() - mode3_prevTime >= 1000) 
-         {
-            mode3_countdown--;
-            mode3_prevTime = millis();
-            if (mode3_countdown > 0) {
-               tone(BUZZER_PIN, 800, 100); 
-            } else {
-               tone(BUZZER_PIN, 2500, 600); 
-               // 측정 시작 초기화
-               mode3_step = 2; 
-               mode3_hitCount = 0;
-               mode3_timerStart = 0; 
-               mode3_lastPhotoState = digitalRead(PHOTO_PIN); // 초기 상태 읽기
-               
-               lcd.clear();
-               lcd.setCursor(0, 0); lcd.print("Release!");
-               lcd.setCursor(0, 1); lcd.print("Waiting sensor..");
-            }
-         }
-      }
-
-      // --- Step 2: 측정 (포토 인터럽터) ---
-      else if (mode3_step == 2)
-      {
-          int photoState = digitalRead(PHOTO_PIN);
-          unsigned long now = millis();
-
-          // 엣지 감지: 막힘 (Beam Broken, 보통 LOW)
-          // PHOTO_PIN이 평소 HIGH(Pullup)이고 막히면 LOW라고 가정 (일반적 BUP-50S 등)
-          // photo_final.cpp 로직 참조: HIGH -> LOW 일 때 blockActive
-          if (mode3_lastPhotoState == HIGH && photoState == LOW) 
-          {
-             // 디바운싱: 너무 빠른 연속 감지 방지 (예: 50ms)
-             if (now - mode3_lastHitMs > 50) 
-             {
-                 mode3_hitCount++;
-                 mode3_lastHitMs = now;
-                 tone(BUZZER_PIN, 1200, 50); // 짧은 삑
-
-                 // === 로직 설명 ===
-                 // Hit 1: 첫 번째 통과 (최저점). 타이머 시작.
-                 // Hit 2: 반대편 갔다가 돌아옴 (1/2 주기) -> 진자 1회 통과
-                 // Hit 3: 다시 원래 방향 (1 주기 완료) -> 진자 2회 통과
-                 // ...
-                 // 우리는 'swing'번의 왕복을 측정하고 싶음.
-                 // 1회 왕복 = 2번의 통과 (왔다 갔다)
-                 // 따라서 swing * 2 번의 추가 통과가 필요함.
-                 // 시작점(Hit 1)을 0초로 잡으면, Hit (1 + swing*2) 에서 멈춰야 함.
-                 
-                 if (mode3_hitCount == 1) 
-                 {
-                     mode3_timerStart = now;
-                     lcd.clear();
-                     lcd.setCursor(0, 0);
-                     lcd.print("Measuring...");
-                 }
-                 else 
-                 {
-                     // 진행 상황 표시 (왕복 횟수)
-                     int currentRoundTrip = (mode3_hitCount - 1) / 2;
-                     lcd.setCursor(0, 1);
-                     lcd.print("Count: "); lcd.print(currentRoundTrip); 
-                     lcd.print("/"); lcd.print(swing);
-
-                     // 종료 조건: 목표 왕복 횟수 채움
-                     if (mode3_hitCount >= (1 + swing * 2)) 
-                     {
-                         mode3_step = 3;
-                         tone(BUZZER_PIN, 2000, 800);
-                     }
-                 }
-             }
-          }
-          mode3_lastPhotoState = photoState;
-      }
-
-      // --- Step 3: 결과 표시 ---
-      else if (mode3_step == 3)
-      {
-          // 계산
-          if (mode3_timerStart > 0) {
-              unsigned long endTime = mode3_lastHitMs; // 마지막 히트 시각
-              float totalTimeSec = (endTime - mode3_timerStart) / 1000.0;
-              time_s = totalTimeSec / (float)swing; // 평균 주기
-
-              lcd.clear();
-              lcd.setCursor(0, 0); lcd.print("T_avg: "); lcd.print(time_s, 3); lcd.print("s");
-              lcd.setCursor(0, 1); lcd.print("Tot: "); lcd.print(totalTimeSec, 2); lcd.print("s");
-
-              mode3_timerStart = 0; // 플래그 리셋하여 계산 1회만 수행
-          }
-
-          // A버튼: 다음(입력 모드)
-          if (A_pressed) {
-              mode = 4; // 입력 모드로
-              mode4_editingStep = 0;
-              updateLcdDisplay();
-          }
-          // B버튼: 재측정
-          if (B_pressed) {
-              mode3_step = 0;
-              mode3_stableStartTime = 0;
-              updateLcdDisplay();
-          }
-      }
-
-      // 측정 도중(Step 0~2) B버튼 누르면 설정 취소
-      if (mode3_step < 3 && B_pressed) {
-          mode = 2; // 다시 Calib 화면이나 모드 선택으로
-          updateLcdDisplay();
-      }
-      break;
-    }
-
-    // ======================================================
-    // Mode 4: Input Variables (Mass & Distance)
-    // ======================================================
-    case 4:
-    {
-      const char* title;
-      if (mode4_editingStep == 0) title = "Set Mass (kg)";
-      else                        title = "Set Dist. (m)";
-
-      if (isInputDone) 
-      {
-        if (mode4_editingStep == 0) { // Mass 완료
-          mass_kg = mode4_getFinalValue(digits); 
-          mode4_editingStep = 1; 
-          mode4_resetInput(digits, currentDigitPosition, lastMappedDigit, isInputDone); 
-          mode4_updateLcd("Set Dist. (m)", digits, currentDigitPosition, isInputDone); 
-        } 
-        else { // Distance 완료 -> 결과 계산 모드(6)로
-          distance_m = mode4_getFinalValue(digits); 
-          
-          mode4_editingStep = 0; 
-          isInputDone = false;     
-          mode = 6; 
-          updateLcdDisplay(); 
-        }
-      }
-      else 
-      {
-        int potVal = analogRead(POT_PIN);
-        int newDigit = map(potVal, 0, 1023, 0, 10);
-        newDigit = constrain(newDigit, 0, 9);
-
-        if (newDigit != lastMappedDigit) {
-            digits[currentDigitPosition] = newDigit;
-            lastMappedDigit = newDigit;
-            mode4_updateLcd(title, digits, currentDigitPosition, isInputDone); 
-        }
-
-        if (A_pressed) {
-            currentDigitPosition++;
-            lastMappedDigit = -1; 
-            if (currentDigitPosition >= 6) isInputDone = true; 
-            else mode4_updateLcd(title, digits, currentDigitPosition, isInputDone); 
-        }
-
-        if (B_pressed) {
-            if (currentDigitPosition > 0) {
-                currentDigitPosition--;
-                lastMappedDigit = -1; 
-                mode4_updateLcd(title, digits, currentDigitPosition, isInputDone);
-            }
-            else {
-                // [탈출 로직 수정] 이전 단계나 측정 모드로 복귀
-                if (mode4_editingStep == 1) { // Distance -> Mass
-                    mode4_editingStep = 0; 
-                    mode4_resetInput(digits, currentDigitPosition, lastMappedDigit, isInputDone);
-                    mode4_updateLcd("Set Mass (kg)", digits, currentDigitPosition, isInputDone);
-                }
-                else { // Mass -> 측정 모드(Photo or Hall)로 복귀
-                    mode = measureSourceMode; // 3 or 5
-                    
-                    // 각 모드 초기화
-                    if(mode == 5) { mode5_step = 3; } // 결과 화면으로? 아니면 0으로
-                    else          { mode3_step = 3; } 
-                    
-                    // 바로 재측정 대기 상태로 보내고 싶다면:
-                    if(mode == 5) { mode5_step = 0; mode5_stableStartTime=0; }
-                    else          { mode3_step = 0; mode3_stableStartTime=0; }
-
-                    mode4_resetInput(digits, currentDigitPosition, lastMappedDigit, isInputDone);
-                    updateLcdDisplay();
-                }
-            }
-        }
-      }
-      break;
-    }
-   
-    // ======================================================
-    // Mode 5: Hall Sensor Measure (기존 유지)
-    // ======================================================
-    case 5: 
-    {
-      int rawAngle = as5600.readAngle();
-      float currentAngle = (float)rawAngle * 360.0 / 4096.0;
-      float calibratedAngle = currentAngle - angleOffset;
-      if (calibratedAngle > 180.0) calibratedAngle -= 360.0;
-      else if (calibratedAngle < -180.0) calibratedAngle += 360.0;
-      float absAngle = fabs(calibratedAngle); 
-
-      static float filteredAbsAngle = 0.0;
-      filteredAbsAngle = (filteredAbsAngle * 0.2) + (absAngle * 0.8);
-      int currentIntAngle = (int)filteredAbsAngle;
-
-      // --- Step 0 ---
-      if (mode5_step == 0)
-      {
-         if (mode5_stableStartTime == 0) { filteredAbsAngle = absAngle; }
-         float diff = fabs(SetAngle - filteredAbsAngle);
-         lcd.setCursor(0, 1);
-         lcd.print("Go to: "); lcd.print(SetAngle, 1);
-         lcd.print(" ("); lcd.print(filteredAbsAngle, 1); lcd.print(")  "); 
-
-         if (diff < 3.0) {
-            if (mode5_stableStartTime == 0) mode5_stableStartTime = millis();
-            if (millis() - mode5_stableStartTime > 1500) {
-               mode5_step = 1; 
-               mode5_countdown = 3;
-               mode5_prevTime = millis();
-               tone(BUZZER_PIN, 1500, 100); 
-               lcd.clear();
-            }
-         }
-         else { mode5_stableStartTime = 0; }
-      }
-      // --- Step 1 ---
-      else if (mode5_step == 1)
-      {
-         lcd.setCursor(0, 0); lcd.print("== Ready? ==");
-         lcd.setCursor(0, 1); lcd.print("Start in "); lcd.print(mode5_countdown); lcd.print("...    ");
-         if (millis() - mode5_prevTime >= 1000) {
-            mode5_countdown--;
-            mode5_prevTime = millis();
-            if (mode5_countdown > 0) tone(BUZZER_PIN, 800, 100); 
-            else {
-               tone(BUZZER_PIN, 2500, 600); 
-               mode5_step = 2; 
-               mode5_swingCount = 0; 
-               mode5_prevIntAngle = currentIntAngle; 
-               mode5_readyForPeak = false; 
-               mode5_timerStart = 0; 
-               lcd.clear(); lcd.setCursor(0, 0); lcd.print("Warm-up..."); 
-            }
-         }
-      }
-      // --- Step 2 ---
-      else if (mode5_step == 2)
-      {
-         unsigned long currentMillis = millis();
-         if (currentIntAngle < 6) mode5_readyForPeak = true;
-         
-         if (mode5_readyForPeak && (mode5_prevIntAngle > currentIntAngle) && (mode5_prevIntAngle > 12))
-         {
-             mode5_swingCount++; 
-             mode5_readyForPeak = false; 
-             tone(BUZZER_PIN, 1000, 50); 
-
-             if (mode5_swingCount == 2) {
-                 mode5_timerStart = millis(); 
-                 lcd.clear(); lcd.setCursor(0, 0); lcd.print("Start! 0/"); lcd.print(swing);
-                 tone(BUZZER_PIN, 1500, 200); 
-             }
-             else if (mode5_swingCount > 2) {
-                 int validPeaks = mode5_swingCount - 2;
-                 if (validPeaks % 2 == 0) {
-                     int validRoundTrip = validPeaks / 2;
-                     lcd.setCursor(0, 0);
-                     lcd.print("Count: "); lcd.print(validRoundTrip); lcd.print("/"); lcd.print(swing);
-                     if (validRoundTrip >= swing) {
-                         mode5_step = 3; 
-                         tone(BUZZER_PIN, 2000, 1000); 
-                         lcd.clear();
-                     }
-                 }
-             }
-         }
-         mode5_prevIntAngle = currentIntAngle;
-
-         if (mode5_timerStart > 0) {
-             float totalElapsed = (currentMillis - mode5_timerStart) / 1000.0;
-             lcd.setCursor(0, 1); lcd.print("Time: "); lcd.print(totalElapsed, 2); lcd.print(" s   ");
-         }
-      }
-      // --- Step 3 ---
-      else if (mode5_step == 3)
-      {
-          unsigned long endTime = millis(); 
-          if (mode5_timerStart > 0) { 
-              float totalTimeSec = (endTime - mode5_timerStart) / 1000.0;
-              time_s = totalTimeSec / swing; 
-
-              lcd.setCursor(0, 0); lcd.print("Avg T: "); lcd.print(time_s, 3); lcd.print(" s");
-              lcd.setCursor(0, 1); lcd.print("Tot: "); lcd.print(totalTimeSec, 2); lcd.print("s");
-              mode5_timerStart = 0; 
-          }
-          if (A_pressed) {
-              mode = 4; // 입력 모드로
-              mode4_editingStep = 0;
-              updateLcdDisplay();
-          }
-          if (B_pressed) {
-            mode5_step = 0; mode5_stableStartTime = 0; updateLcdDisplay(); 
-          }
-      }
-      // Step 0~2에서 B 누르면
-      if (mode5_step < 3 && B_pressed) {
-          mode = 2; updateLcdDisplay();
-      }
-      break;
-    }
-
-    // ======================================================
-    // Mode 6: Calculation Result
-    // ======================================================
-    case 6:
-    {
-      float T = time_s;
-      float M = mass_kg;
-      float D = distance_m;
-      float g = 9.80665;
-      float PI_VAL = 3.14159265;
-      float I_value = 0.0;
-      
-      if (M > 0 && D > 0) I_value = (T * T * M * g * D) / (4 * PI_VAL * PI_VAL);
-
-      lcd.setCursor(0, 0);
-      lcd.print("I="); lcd.print(I_value, 5); lcd.print(" kgm^2 ");
+  finishPass();
 
-      lcd.setCursor(0, 1);
-      lcd.print("A:Reset B:Back");
-
-      if (A_pressed) {
-        mode = 0; // 완전 초기화
-        updateLcdDisplay();
-      }
-      if (B_pressed) {
-        // [수정] 측정했던 모드로 돌아가기
-        mode = measureSourceMode; 
-        
-        // 결과 화면 상태로 복귀
-        if(mode == 5) mode5_step = 3;
-        else          mode3_step = 3;
-        
-        updateLcdDisplay();
-      }
-      break;
-    }
-  }
-  
   // 측정 중(Mode 3 step 2)일 때는 루프 지연을 최소화하여 센서 미스를 방지
-  if (mode == 3 && mode3_step == 2) {
-      // No delay
+  if (mode == 3 && modeState.m3.step == 2) {
+      bus.service(); // No delay
   } else {
-      delay(10);
+      holdMs(10);
   }
 }
\ No newline at end of file
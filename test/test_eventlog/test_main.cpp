@@ -0,0 +1,150 @@
+// EventLog 왕복 확인 (pio test -e native)
+// 넣은 시각(4us 단위)이 순차 읽기 / at(i) 둘 다로 그대로 나오는지:
+// micros() 넘침, 체크포인트 경계, 큰 간격(varint 5바이트), 가득 찬 뒤 append 실패
+#include <unity.h>
+#include "EventLog.h"
+
+static uint32_t synthHalfPeriod(uint16_t& seed, uint16_t i)
+{
+    seed = seed * 25173U + 13849U;                          // Bench.cpp와 같은 16비트 LCG
+    uint32_t base = (i & 1) ? 480000UL : 520000UL;          // 짧은/긴 반주기 번갈아
+    return (base + (seed >> 7) - 256) & ~3UL;               // ±256us 지터, 4us 단위
+}
+
+// log의 모든 이벤트가 want[0..n)과 같은지 (순차 + 임의 접근)
+template <class Log>
+static void checkSame(const Log& log, const uint32_t* want, uint16_t n)
+{
+    TEST_ASSERT_EQUAL_UINT16(n, log.count());
+    typename Log::Reader r(log);
+    uint32_t t;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        TEST_ASSERT_TRUE(r.next(t));
+        TEST_ASSERT_EQUAL_HEX32(want[i], t);
+        TEST_ASSERT_EQUAL_HEX32(want[i], log.at(i));
+    }
+    TEST_ASSERT_FALSE(r.next(t));
+    TEST_ASSERT_EQUAL_HEX32(0, log.at(n));
+    if (n)
+    {
+        TEST_ASSERT_EQUAL_HEX32(want[0], log.first());
+        TEST_ASSERT_EQUAL_HEX32(want[n - 1], log.last());
+    }
+}
+
+static RunLog runLogUnderTest;
+
+void test_wrap_and_checkpoints()
+{
+    static uint32_t want[1024];
+    RunLog& log = runLogUnderTest;
+    log.clear();
+    uint16_t seed = 1;
+    uint32_t t = 0xFFF00000UL; // 1초 안에 micros() 넘침
+    uint16_t n = 0;
+    while (n < 1024 && log.append(t))
+    {
+        want[n++] = t;
+        t += synthHalfPeriod(seed, n);
+    }
+    TEST_ASSERT_TRUE(n > 3 * 32); // 체크포인트 여러 개를 지남
+    TEST_ASSERT_TRUE(want[n - 1] < want[0]); // 넘침을 지남
+    checkSame(log, want, n);
+
+    // 체크포인트 앞뒤에서 시작하는 Reader
+    for (uint16_t from = 30; from < 35; from++)
+    {
+        RunLog::Reader r(log, from);
+        uint32_t got;
+        TEST_ASSERT_TRUE(r.next(got));
+        TEST_ASSERT_EQUAL_HEX32(want[from], got);
+    }
+}
+
+void test_large_deltas()
+{
+    const uint32_t gaps[] = { 4, 0x7FFFFFFCUL, 4, 1000000, 0xFFFFFFFCUL, 8, 480000, 520000, 0x40000000UL, 4 };
+    const uint16_t n = sizeof(gaps) / sizeof(gaps[0]) + 1;
+    uint32_t want[n];
+    EventLog<128, 4> log;
+    log.clear();
+    uint32_t t = 0x12345678UL & ~3UL;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        want[i] = t;
+        TEST_ASSERT_TRUE(log.append(t));
+        if (i < n - 1) t += gaps[i];
+    }
+    checkSame(log, want, n);
+}
+
+void test_full_keeps_contents()
+{
+    // 바이트가 먼저 참: 잔차가 큰 이벤트(여러 바이트)로 16바이트를 채움
+    {
+        static uint32_t want[64];
+        EventLog<16, 8> log;
+        log.clear();
+        uint32_t t = 0;
+        uint16_t n = 0;
+        for (uint16_t i = 0; i < 64; i++)
+        {
+            if (!log.append(t)) break;
+            want[n++] = t;
+            t += 4 + ((uint32_t)i << 20); // 간격이 계속 늘어서 예측이 틀림
+        }
+        TEST_ASSERT_TRUE(n < 64);
+        TEST_ASSERT_TRUE(log.bytesUsed() <= 16);
+        TEST_ASSERT_FALSE(log.append(t));  // 실패는 계속 실패
+        checkSame(log, want, n);           // 저장된 것은 그대로
+    }
+    // 체크포인트가 먼저 참: 블록마다 이벤트 1개(1바이트) + 체크포인트 1개
+    {
+        static uint32_t want[64];
+        EventLog<8, 2> log;
+        log.clear();
+        uint32_t t = 1000;
+        uint16_t n = 0;
+        for (uint16_t i = 0; i < 64; i++)
+        {
+            if (!log.append(t)) break;
+            want[n++] = t;
+            t += 500000;
+        }
+        TEST_ASSERT_TRUE(n < 64);
+        TEST_ASSERT_FALSE(log.append(t));
+        checkSame(log, want, n);
+    }
+}
+
+void test_clear()
+{
+    EventLog<32> log;
+    log.clear();
+    TEST_ASSERT_TRUE(log.empty());
+    TEST_ASSERT_EQUAL_HEX32(0, log.first());
+    TEST_ASSERT_EQUAL_HEX32(0, log.last());
+    TEST_ASSERT_TRUE(log.append(400));
+    TEST_ASSERT_TRUE(log.append(900));
+    log.clear();
+    TEST_ASSERT_TRUE(log.empty());
+    TEST_ASSERT_EQUAL_UINT16(0, log.bytesUsed());
+    const uint32_t want[] = { 8, 12 };
+    TEST_ASSERT_TRUE(log.append(8));
+    TEST_ASSERT_TRUE(log.append(12));
+    checkSame(log, want, 2);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_wrap_and_checkpoints);
+    RUN_TEST(test_large_deltas);
+    RUN_TEST(test_full_keeps_contents);
+    RUN_TEST(test_clear);
+    return UNITY_END();
+}
@@ -0,0 +1,90 @@
+// FastPin 시뮬레이션 포트 확인 (pio test -e native)
+// simSet()으로 넣은 입력 레벨이 read()로, write()/high()/low()/toggle()이 출력 레지스터로 그대로 가는지,
+// 같은 포트의 다른 핀은 건드리지 않는지
+#include <unity.h>
+#include "FastPin.h"
+
+typedef FastPin<5>  PinD5;  // PORTD bit 5 (포토 핀 자리)
+typedef FastPin<6>  PinD6;  // 같은 포트
+typedef FastPin<9>  PinB1;  // PORTB bit 1 (부저 자리)
+typedef FastPin<14> PinC0;  // A0
+
+void test_sim_input()
+{
+    PinD5::simSet(false);
+    TEST_ASSERT_FALSE(PinD5::read());
+    PinD5::simSet(true);
+    TEST_ASSERT_TRUE(PinD5::read());
+
+    PinD6::simSet(false);
+    TEST_ASSERT_TRUE(PinD5::read()); // 같은 포트, 다른 비트는 그대로
+    TEST_ASSERT_FALSE(PinD6::read());
+    TEST_ASSERT_EQUAL_HEX8(0, pinmap::Regs<pinmap::PORT_ID_D>::in() & (1 << 6));
+
+    PinC0::simSet(false);
+    TEST_ASSERT_TRUE(PinD5::read()); // 다른 포트도 그대로
+    TEST_ASSERT_FALSE(PinC0::read());
+}
+
+void test_write()
+{
+    volatile uint8_t& out = pinmap::Regs<pinmap::PORT_ID_B>::out();
+    out = 0x00;
+    PinB1::high();
+    TEST_ASSERT_EQUAL_HEX8(0x02, out);
+    PinB1::write(false);
+    TEST_ASSERT_EQUAL_HEX8(0x00, out);
+    PinB1::write(true);
+    TEST_ASSERT_EQUAL_HEX8(0x02, out);
+    PinB1::toggle();
+    TEST_ASSERT_EQUAL_HEX8(0x00, out);
+    PinB1::toggle();
+    TEST_ASSERT_EQUAL_HEX8(0x02, out);
+
+    out = 0xFD; // 다른 비트는 모두 1
+    PinB1::low();
+    TEST_ASSERT_EQUAL_HEX8(0xFD, out);
+    PinB1::high();
+    TEST_ASSERT_EQUAL_HEX8(0xFF, out);
+    PinB1::low();
+    TEST_ASSERT_EQUAL_HEX8(0xFD, out);
+}
+
+void test_direction()
+{
+    volatile uint8_t& ddr = pinmap::Regs<pinmap::PORT_ID_D>::ddr();
+    volatile uint8_t& out = pinmap::Regs<pinmap::PORT_ID_D>::out();
+    ddr = 0x00;
+    out = 0x00;
+    PinD6::output();
+    TEST_ASSERT_EQUAL_HEX8(0x40, ddr);
+    PinD6::inputPullup();
+    TEST_ASSERT_EQUAL_HEX8(0x00, ddr);
+    TEST_ASSERT_EQUAL_HEX8(0x40, out); // 풀업 = 입력 + PORT 비트 1
+    PinD6::input();
+    TEST_ASSERT_EQUAL_HEX8(0x00, out);
+}
+
+void test_pinmap()
+{
+    TEST_ASSERT_EQUAL_UINT8(pinmap::PORT_ID_D, PinD5::PORT_ID);
+    TEST_ASSERT_EQUAL_UINT8(pinmap::PORT_ID_B, PinB1::PORT_ID);
+    TEST_ASSERT_EQUAL_UINT8(pinmap::PORT_ID_C, PinC0::PORT_ID);
+    TEST_ASSERT_EQUAL_UINT8(9, pinmap::pinOf(pinmap::PORT_ID_B, 1));
+    TEST_ASSERT_EQUAL_UINT8(0x60, (pinmap::MaskOf<5, 6>::value));
+    TEST_ASSERT_TRUE((pinmap::AllOnPort<pinmap::PORT_ID_D, 2, 3, 7>::value));
+    TEST_ASSERT_FALSE((pinmap::AllOnPort<pinmap::PORT_ID_D, 2, 9>::value));
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_sim_input);
+    RUN_TEST(test_write);
+    RUN_TEST(test_direction);
+    RUN_TEST(test_pinmap);
+    return UNITY_END();
+}
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+# [env:uno_bench] 출력(bench,<name>,<unit>,<value>)을 한계값과 비교. 하나라도 넘으면 종료 코드 1.
+#
+#   python3 tools/bench_check.py --port /dev/ttyACM0       (보드 리셋 후 bench,end까지 읽음)
+#   python3 tools/bench_check.py bench_output.txt          (저장한 출력)
+#   python3 tools/bench_check.py --limits tools/bench_limits_gates.csv --port /dev/ttyACM0   ([env:uno_gates_bench])
+import argparse
+import os
+import sys
+
+LIMITS = os.path.join(os.path.dirname(os.path.abspath(__file__)), "bench_limits.csv")
+
+
+def read_lines(args):
+    if args.port:
+        import serial  # pyserial
+
+        with serial.Serial(args.port, args.baud, timeout=30) as s:
+            while True:
+                line = s.readline().decode(errors="replace").strip()
+                if not line:
+                    raise SystemExit("bench: timeout")
+                yield line
+                if line == "bench,end":
+                    return
+    else:
+        with open(args.file) if args.file else sys.stdin as f:
+            for line in f:
+                yield line.strip()
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("file", nargs="?")
+    ap.add_argument("--port")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--limits", default=LIMITS)
+    args = ap.parse_args()
+
+    values = {}
+    for line in read_lines(args):
+        parts = line.split(",")
+        if len(parts) == 4 and parts[0] == "bench":
+            values[parts[1]] = int(parts[3])
+
+    failed = 0
+    with open(args.limits) as f:
+        for row in f:
+            row = row.strip()
+            if not row or row.startswith("#"):
+                continue
+            name, op, limit = row.split(",")
+            limit = int(limit)
+            v = values.get(name)
+            ok = v is not None and (v <= limit if op == "max" else v >= limit)
+            failed += not ok
+            print("check,%s,%s,%s%d,%s" % (name, v, "<=" if op == "max" else ">=", limit, "PASS" if ok else "FAIL"))
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+# Uno 레조네이터 시간 기준 보정: Serial로 시각을 주고받아 ppm 오차를 회귀로 구하고 EEPROM에 저장
+#
+#   python3 tools/clock_cal.py /dev/ttyACM0 --minutes 3                 (재기만)
+#   python3 tools/clock_cal.py /dev/ttyACM0 --minutes 3 --store --verify 1
+#   python3 tools/clock_cal.py --simulate 850 --minutes 3 --store --verify 1   (가짜 보드로 추정기 확인)
+#
+# 측정: 보드가 측정하지 않을 때(Mode 0 등) 'S'를 interval마다 보내고 "sync,<micros>" 답을 받은 시각과 짝지음.
+#   기준 시계 = 호스트 monotonic (NTP가 속도를 맞춰 주는 시계). micros() 넘침(71분)은 풀어서 씀.
+#   보드는 loop()에서 글자를 보자마자 micros()를 찍고 바로 답하므로 찍은 뒤 받을 때까지는 거의 일정하고,
+#   찍기 전 대기(loop 한 바퀴, I2C 대기)는 왕복 시간만 늘림 → 왕복이 중앙값보다 긴 교환은 버림.
+#   남은 점으로 보드 시각 = a + b * 호스트 시각 직선 맞춤, 잔차 3 sigma 밖은 빼고 다시 맞춤.
+#   ppm = (b - 1) * 1e6,  sigma = 기울기 표준오차.  T는 ppm만큼, I(T^2에 비례)는 2배만큼 틀림.
+# --store: 'K<ppm>'로 저장 → 보드가 모든 주기를 us / (1 + ppm 1e-6)로 바꿈 (include/ClockCal.h)
+# --verify M: 저장한 뒤 M분 더 재서 남은 오차 = 새 추정값을 저장값으로 나눈 비율 (온도 변화 등)
+# 출력: clk_fit,<쓴 교환 수>,<전체 교환 수>,<구간 s>,<ppm>,<sigma ppm>,<잔차 rms us>,<잔차 최대 us>,<I 오차 ppm>
+#       clk_store,<보드가 돌려준 ppm>
+#       clk_resid,<남은 ppm>,<sigma ppm>,<잔차 rms us>,<I 남은 오차 ppm>
+import argparse
+import math
+import random
+import sys
+import time
+
+WRAP = 1 << 32
+
+
+class Board:
+    def __init__(self, port, baud):
+        import serial  # pyserial
+
+        self.s = serial.Serial(port, baud, timeout=1.0)
+        time.sleep(2.0)  # 포트 열면 보드 리셋 → 부팅 대기
+        self.s.reset_input_buffer()
+
+    def _line(self, prefix):
+        while True:
+            got = self.s.readline().decode(errors="replace").strip()
+            if not got:
+                return None
+            if got.startswith(prefix):
+                return got
+
+    def sync(self):
+        """(보낸 호스트 ns, 받은 호스트 ns, 보드 micros) 또는 None"""
+        t_send = time.monotonic_ns()
+        self.s.write(b"S")
+        got = self._line("sync,")
+        t_recv = time.monotonic_ns()
+        return (t_send, t_recv, int(got.split(",")[1])) if got else None
+
+    def wait(self, seconds):
+        time.sleep(seconds)
+
+    def store(self, ppm):
+        self.s.write(b"K%.2f\n" % ppm)
+        got = self._line("clk,")
+        if got is None or got == "clk,err":
+            raise SystemExit("board refused %.2f ppm (%s)" % (ppm, got))
+        return float(got.split(",")[1])
+
+
+class FakeBoard:
+    """ppm 빠른 보드: loop 대기(지수 분포 + 가끔 LCD/I2C 대기), USB 1ms 프레임, micros 넘침, 온도 드리프트"""
+
+    def __init__(self, ppm, drift_ppm_per_min, seed):
+        self.rng = random.Random(seed)
+        self.ppm, self.drift = ppm, drift_ppm_per_min
+        self.now = 0.0  # 가상 호스트 시각 (s)
+        self.dev = self.rng.randrange(WRAP) * 1.0  # 보드 micros (넘침 확인)
+        self.stored = 0.0
+
+    def _advance(self, dt):
+        rate = 1.0 + (self.ppm + self.drift * self.now / 60.0) * 1e-6
+        self.now += dt
+        self.dev += dt * 1e6 * rate
+
+    def sync(self):
+        t_send = self.now
+        self._advance(0.0015 + self.rng.random() * 0.001)  # USB 내려감
+        wait = self.rng.expovariate(1 / 0.002) + (0.03 if self.rng.random() < 0.05 else 0.0)
+        self._advance(wait)  # 보드 loop이 글자를 볼 때까지
+        stamp = int(self.dev) % WRAP
+        self._advance(0.0008 + 0.001 * self.rng.random())  # 답 14바이트 + USB 프레임
+        return int(t_send * 1e9), int(self.now * 1e9), stamp
+
+    def wait(self, seconds):
+        self._advance(seconds)
+
+    def store(self, ppm):
+        self.stored = round(ppm, 2)
+        return self.stored
+
+
+def collect(board, minutes, interval):
+    pts, n = [], 0
+    end = None
+    while True:
+        r = board.sync()
+        n += 1
+        if r is not None:
+            pts.append(r)
+            if end is None:
+                end = r[1] + int(minutes * 60e9)
+            elif r[1] >= end:
+                break
+        board.wait(interval)
+    return pts, n
+
+
+def fit(pts):
+    """(ppm, sigma ppm, 잔차 rms us, 최대 us, 쓴 수, 구간 s)"""
+    rtts = sorted(r - s for s, r, _ in pts)
+    limit = rtts[len(rtts) // 2]
+    t0, d0 = pts[0][1], pts[0][2]
+    xs, ys, prev, wraps = [], [], d0, 0
+    for s, r, d in pts:
+        if d < prev:
+            wraps += 1
+        prev = d
+        if r - s <= limit:
+            xs.append((r - t0) * 1e-9)
+            ys.append((d + wraps * WRAP - d0) * 1e-6)
+    keep = list(range(len(xs)))
+    while True:
+        n = len(keep)
+        mx = sum(xs[i] for i in keep) / n
+        my = sum(ys[i] for i in keep) / n
+        sxx = sum((xs[i] - mx) ** 2 for i in keep)
+        b = sum((xs[i] - mx) * (ys[i] - my) for i in keep) / sxx
+        a = my - b * mx
+        res = {i: ys[i] - a - b * xs[i] for i in keep}
+        s = math.sqrt(sum(v * v for v in res.values()) / (n - 2))
+        inside = [i for i in keep if abs(res[i]) <= 3 * s]
+        if len(inside) == n:
+            break
+        keep = inside
+    span = xs[keep[-1]] - xs[keep[0]]
+    return ((b - 1) * 1e6, s / math.sqrt(sxx) * 1e6, s * 1e6, max(abs(v) for v in res.values()) * 1e6, n, span)
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("port", nargs="?")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--minutes", type=float, default=3.0)
+    ap.add_argument("--interval", type=float, default=0.25, help="교환 간격 (s)")
+    ap.add_argument("--store", action="store_true", help="구한 ppm을 보드 EEPROM에 저장")
+    ap.add_argument("--verify", type=float, default=0.0, help="저장 뒤 이만큼(분) 더 재서 남은 오차 보고")
+    ap.add_argument("--simulate", type=float, metavar="PPM", help="보드 대신 가짜 보드 (이 ppm만큼 빠름)")
+    ap.add_argument("--sim-drift", type=float, default=0.0, help="가짜 보드 온도 드리프트 (ppm/분)")
+    ap.add_argument("--seed", type=int, default=1)
+    args = ap.parse_args()
+
+    if args.simulate is not None:
+        board = FakeBoard(args.simulate, args.sim_drift, args.seed)
+    elif args.port:
+        board = Board(args.port, args.baud)
+    else:
+        raise SystemExit("need a serial port or --simulate PPM")
+
+    pts, n = collect(board, args.minutes, args.interval)
+    if len(pts) < 10:
+        raise SystemExit("only %d sync replies (board busy measuring?)" % len(pts))
+    ppm, sigma, rms, worst, used, span = fit(pts)
+    print("clk_fit,%d,%d,%.1f,%.2f,%.2f,%.0f,%.0f,%.1f" % (used, n, span, ppm, sigma, rms, worst, 2 * ppm))
+    if not args.store:
+        return
+    stored = board.store(ppm)
+    print("clk_store,%.2f" % stored)
+    if args.verify > 0:
+        pts, _ = collect(board, args.verify, args.interval)
+        ppm2, sigma2, rms2, _, _, _ = fit(pts)
+        resid = ((1 + ppm2 * 1e-6) / (1 + stored * 1e-6) - 1) * 1e6
+        print("clk_resid,%.2f,%.2f,%.0f,%.1f" % (resid, sigma2, rms2, 2 * resid))
+    sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
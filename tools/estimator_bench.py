@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+# 주기 추정기 비교: 왕복 수(경과 시간)에 따른 관성모멘트 오차, 목표 불확도까지 걸리는 시간
+#
+#   python3 tools/estimator_bench.py --runs 2000 --swings 20 --target-ppm 1000 > est.csv
+#
+# 조건(감쇠 x 진폭 x 잡음)마다 runs 번 시뮬레이션 (pendulum_sim.Run), 시드 고정 → 같은 인자면 같은 결과.
+# 출력 (CSV):
+#   err,<추정기>,<decay>,<amp_deg>,<noise>,<swings>,<elapsed_s>,<rms_I_ppm>,<valid>
+#   ttt,<추정기>,<decay>,<amp_deg>,<noise>,<target_ppm>,<elapsed_s 또는 none>
+# I ∝ T² 이므로 I 상대오차 = (T_est / T)² - 1.
+# hall_freq_track은 이벤트 시각이 아니라 s 왕복 시점까지 스트림으로 낸 주기 추정값 (include/FreqTracker.h).
+import argparse
+import itertools
+import math
+import multiprocessing
+import random
+
+import pendulum_sim as sim
+
+PERIOD = 1.6
+
+# (이름, 이벤트 생성, 추정식)
+ESTIMATORS = [
+    ("photo_endpoint",   lambda r, n: r.gate_events(n, gate_deg=1.0),              sim.endpoint),  # Mode 3
+    ("photo_lsq",        lambda r, n: r.gate_events(n, gate_deg=1.0),              sim.lsq),
+    ("photo_mid_lsq",    lambda r, n: r.gate_events(n, gate_deg=0.0),              sim.lsq),
+    ("hall_fw_endpoint", lambda r, n: r.firmware_peaks(n, noise_counts=r.noise),   sim.endpoint),  # Mode 5
+    ("hall_peak_lsq",    lambda r, n: r.stream_peaks(n, noise_counts=r.noise, interp=False), sim.lsq),
+    ("hall_interp_lsq",  lambda r, n: r.stream_peaks(n, noise_counts=r.noise),     sim.lsq),
+    ("hall_zero_lsq",    lambda r, n: r.stream_zeros(n, noise_counts=r.noise),     sim.lsq),
+    ("hall_freq_track",  lambda r, n: r.freq_track(n, noise_counts=r.noise),       sim.tracked),   # FreqTracker
+]
+
+
+def run_chunk(task):
+    cond_idx, (decay, amp, noise), seeds, swings = task
+    n_half = 2 * swings + 1
+    sq = [[0.0] * (swings + 1) for _ in ESTIMATORS]
+    ok = [[0] * (swings + 1) for _ in ESTIMATORS]
+    for seed in seeds:
+        for e, (_, events, estimate) in enumerate(ESTIMATORS):
+            rng = random.Random(hash((seed, cond_idx, e)))  # 조건/추정기마다 겹치지 않는 잡음 (정수 튜플 hash는 실행마다 같음)
+            run = sim.Run(rng, period=PERIOD, amp_deg=amp, decay=decay)
+            run.noise = noise
+            ev = events(run, n_half)
+            for s in range(1, swings + 1):
+                T = estimate(ev, 2 * s)
+                if T is None:
+                    continue
+                err = (T / PERIOD) ** 2 - 1.0
+                sq[e][s] += err * err
+                ok[e][s] += 1
+    return cond_idx, sq, ok
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--runs", type=int, default=1000)
+    ap.add_argument("--swings", type=int, default=20)
+    ap.add_argument("--seed", type=int, default=1)
+    ap.add_argument("--target-ppm", type=float, default=1000.0)
+    ap.add_argument("--decay", type=float, nargs="+", default=[0.005, 0.02, 0.05])
+    ap.add_argument("--amp", type=float, nargs="+", default=[5.0, 10.0, 20.0])
+    ap.add_argument("--noise", type=float, nargs="+", default=[0.5, 2.0])
+    ap.add_argument("--jobs", type=int, default=multiprocessing.cpu_count())
+    args = ap.parse_args()
+
+    conds = list(itertools.product(args.decay, args.amp, args.noise))
+    chunk = max(1, args.runs // (4 * args.jobs))
+    tasks = []
+    for ci, cond in enumerate(conds):
+        seeds = list(range(args.seed * 1000003, args.seed * 1000003 + args.runs))
+        for i in range(0, args.runs, chunk):
+            tasks.append((ci, cond, seeds[i:i + chunk], args.swings))
+
+    sq = {ci: [[0.0] * (args.swings + 1) for _ in ESTIMATORS] for ci in range(len(conds))}
+    ok = {ci: [[0] * (args.swings + 1) for _ in ESTIMATORS] for ci in range(len(conds))}
+    with multiprocessing.Pool(args.jobs) as pool:
+        for ci, s2, n in pool.imap_unordered(run_chunk, tasks):
+            for e in range(len(ESTIMATORS)):
+                for s in range(args.swings + 1):
+                    sq[ci][e][s] += s2[e][s]
+                    ok[ci][e][s] += n[e][s]
+
+    for ci, (decay, amp, noise) in enumerate(conds):
+        for e, (name, _, _) in enumerate(ESTIMATORS):
+            ttt = None
+            for s in range(1, args.swings + 1):
+                n = ok[ci][e][s]
+                rms = math.sqrt(sq[ci][e][s] / n) * 1e6 if n else float("nan")
+                valid = n / float(args.runs)
+                print("err,%s,%g,%g,%g,%d,%.2f,%.1f,%.3f" % (name, decay, amp, noise, s, s * PERIOD, rms, valid))
+                if ttt is None and n and valid >= 0.99 and rms <= args.target_ppm:
+                    ttt = s * PERIOD
+            print("ttt,%s,%g,%g,%g,%g,%s" % (name, decay, amp, noise, args.target_ppm,
+                                             "none" if ttt is None else "%.2f" % ttt))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,254 @@
+"""진자 실행 시뮬레이션 (호스트 도구 공용, 표준 라이브러리만 사용)
+
+감쇠 진자  theta(t) = A * exp(-decay * t) * cos(2*pi*t / T),  t = 0 에서 놓음 (피크).
+펌웨어가 보는 이벤트 시각(반주기 간격)을 만들어 냄:
+  gate_events      : 포토 게이트 (Mode 3). 게이트 위치 gate_deg, 폴링 지연 + micros() 4us 해상도
+  stream_peaks     : 각도 스트림(fs Hz, 잡음 + 12비트 양자화)에서 피크 샘플 / 포물선 보간 피크
+  stream_zeros     : 각도 스트림의 0점 통과 (선형 보간, 가장 빠르게 움직이는 순간)
+  firmware_peaks   : Mode 5 규칙 그대로 (EMA, 정수 각도, arm/peak 임계) - 루프 주기로 샘플
+  freq_track       : 각도 스트림을 FreqTracker(include/FreqTracker.h와 같은 정수 연산, float은 float32로 반올림)에 넣은 주기 추정값
+주기 추정기:
+  endpoint         : (마지막 - 처음) / 왕복 수  (지금 Mode 3/5)
+  lsq              : t_k = a + k*h + b*(-1)^k 최소제곱, T = 2h  (중심에서 벗어난 게이트의 짧은/긴 반주기 흡수)
+  tracked          : freq_track 값 그대로 (이벤트 시각이 아니라 그 시점까지의 주기 추정)
+"""
+import math
+import struct
+
+COUNTS_PER_DEG = 4096.0 / 360.0
+TICK_US = 4.0  # micros() 해상도 (16MHz)
+
+# Mode 5 검출기 기본값 (include/DetectorParams.h)
+FIRMWARE_DEFAULTS = {
+    "arm_deg": 4,        # currentIntAngle < DET_HALL_ARM_DEG 이면 다음 피크 준비
+    "peak_deg": 6,       # prevIntAngle > DET_HALL_PEAK_DEG 에서 내려가기 시작하면 피크
+    "ema_old": 0.4,      # filtered = old*ema_old + new*(1-ema_old)
+}
+
+
+class Run:
+    def __init__(self, rng, period=1.6, amp_deg=10.0, decay=0.01):
+        self.rng = rng
+        self.period = period
+        self.amp = amp_deg
+        self.decay = decay
+        self.w = 2.0 * math.pi / period
+
+    def angle(self, t):
+        return self.amp * math.exp(-self.decay * t) * math.cos(self.w * t)
+
+    def _crossing(self, lo, hi, level):
+        f_lo = self.angle(lo) - level
+        for _ in range(50):
+            mid = 0.5 * (lo + hi)
+            f_mid = self.angle(mid) - level
+            if (f_mid < 0) == (f_lo < 0):
+                lo, f_lo = mid, f_mid
+            else:
+                hi = mid
+        return 0.5 * (lo + hi)
+
+    def _measure(self, deg, noise_counts):
+        c = round((deg + self.rng.gauss(0.0, noise_counts / COUNTS_PER_DEG)) * COUNTS_PER_DEG)
+        return c / COUNTS_PER_DEG
+
+    # 포토 게이트: 반주기 k마다 게이트 위치를 지나는 시각 (k = 0..n-1)
+    def gate_events(self, n, gate_deg=0.0, poll_us=200.0, jitter_us=20.0):
+        half = 0.5 * self.period
+        out = []
+        for k in range(n):
+            lo, hi = k * half, (k + 1) * half
+            if abs(gate_deg) >= self.amp * math.exp(-self.decay * hi):
+                break  # 진폭이 게이트까지 못 옴 → 놓침
+            t = self._crossing(lo, hi, gate_deg) * 1e6
+            t += self.rng.uniform(0.0, poll_us) + self.rng.gauss(0.0, jitter_us)
+            out.append(math.floor(t / TICK_US) * TICK_US / 1e6)
+        return out
+
+    def _window(self, center, half_width, fs, phase):
+        j0 = math.ceil((center - half_width - phase) * fs)
+        j1 = math.floor((center + half_width - phase) * fs)
+        return [phase + j / fs for j in range(max(j0, 0), j1 + 1)]
+
+    # 각도 스트림 피크 (k = 1..n, 놓은 순간 피크는 빼고 첫 반주기 끝부터)
+    def stream_peaks(self, n, fs=1000.0, noise_counts=1.0, interp=True):
+        phase = self.rng.uniform(0.0, 1.0 / fs)
+        half = 0.5 * self.period
+        out = []
+        for k in range(1, n + 1):
+            ts = self._window(k * half, 0.1 * self.period, fs, phase)
+            sign = -1.0 if k % 2 else 1.0
+            ys = [sign * self._measure(self.angle(t), noise_counts) for t in ts]
+            i = max(range(len(ys)), key=ys.__getitem__)
+            t = ts[i]
+            if interp and 0 < i < len(ys) - 1:
+                den = ys[i - 1] - 2.0 * ys[i] + ys[i + 1]
+                if den < 0:
+                    t += 0.5 * (ys[i - 1] - ys[i + 1]) / den / fs
+            out.append(t)
+        return out
+
+    # 0점 통과 (k = 0..n-1)
+    def stream_zeros(self, n, fs=1000.0, noise_counts=1.0):
+        phase = self.rng.uniform(0.0, 1.0 / fs)
+        half = 0.5 * self.period
+        out = []
+        for k in range(n):
+            ts = self._window((k + 0.5) * half, 0.05 * self.period, fs, phase)
+            ys = [self._measure(self.angle(t), noise_counts) for t in ts]
+            mid = len(ys) // 2
+            best = None
+            for i in range(len(ys) - 1):
+                if (ys[i] <= 0.0) != (ys[i + 1] <= 0.0) and ys[i] != ys[i + 1]:
+                    tc = ts[i] + (ts[i + 1] - ts[i]) * ys[i] / (ys[i] - ys[i + 1])
+                    if best is None or abs(i - mid) < abs(best[0] - mid):
+                        best = (i, tc)
+            if best is None:
+                break
+            out.append(best[1])
+        return out
+
+    # 반주기 k = 0..n 끝 시각((k+1) * T/2)마다 FreqTracker 전체 스트림 주기 추정 (s, 아직 없으면 None)
+    # 샘플: fs Hz, 12비트 정수 각도 (0점 기준 부호 있음), micros() 4us 해상도
+    def freq_track(self, n, fs=1000.0, noise_counts=1.0):
+        tr = FreqTracker()
+        half = 0.5 * self.period
+        out = []
+        t = self.rng.uniform(0.0, 1.0 / fs)
+        for k in range(n + 1):
+            end = (k + 1) * half
+            while t < end:
+                c = round((self.angle(t) + self.rng.gauss(0.0, noise_counts / COUNTS_PER_DEG)) * COUNTS_PER_DEG)
+                tr.push(int(t * 1e6 // TICK_US * TICK_US), c)
+                t += 1.0 / fs
+            out.append(tr.run_period_us * 1e-6 if tr.run_period_us else None)
+        return out
+
+    # Mode 5 검출 규칙 (loop 패스마다 각도 한 번). duration 초 동안 피크로 센 시각 전부
+    def firmware_detections(self, duration, loop_hz=90.0, noise_counts=1.0, params=None):
+        p = dict(FIRMWARE_DEFAULTS, **(params or {}))
+        dt = 1.0 / loop_hz
+        t = self.rng.uniform(0.0, dt)
+        filtered = abs(self._measure(self.angle(t), noise_counts))
+        prev = int(filtered)
+        ready = False
+        out = []
+        while t < duration:
+            t += dt * self.rng.uniform(0.9, 1.1)  # 루프 주기 흔들림 (LCD/I2C)
+            a = abs(self._measure(self.angle(t), noise_counts))
+            filtered = filtered * p["ema_old"] + a * (1.0 - p["ema_old"])
+            cur = int(filtered)
+            if cur < p["arm_deg"]:
+                ready = True
+            if ready and prev > cur and prev > p["peak_deg"]:
+                ready = False
+                out.append(t)
+            prev = cur
+        return out
+
+    # Mode 5 측정에 쓰는 피크: 첫 검출은 버리고 (swingCount == 2) 시작 피크부터 n개
+    def firmware_peaks(self, n, loop_hz=90.0, noise_counts=1.0, params=None):
+        duration = (n + 2) * 0.5 * self.period + self.period
+        return self.firmware_detections(duration, loop_hz, noise_counts, params)[1:n + 1]
+
+
+def f32(x):
+    """AVR float(= double, 32비트)로 반올림"""
+    return struct.unpack("f", struct.pack("f", x))[0]
+
+
+class FreqTracker:
+    """include/FreqTracker.h 흉내: 정수 부분(int32 누적, 0 쪽으로 자르는 나눗셈, 산술 시프트)은 같고,
+    float 누적/풀이는 연산마다 float32로 반올림. sqrt/acos는 avr-libc와 마지막 자리가 다를 수 있음 (비트 단위로 같지는 않음)"""
+
+    def __init__(self, bin_us=50000, shift=5):
+        self.bin_us, self.shift = bin_us, shift
+        self.bin_start = None
+        self.bin_sum = self.bin_n = 0
+        self.prev = None
+        self.d = []
+        self.a2 = self.a4 = 0
+        self.s2 = self.s4 = 0.0
+        self.period_us = self.run_period_us = 0.0
+
+    def _solve(self, a2, a4):
+        if a2 <= 0:
+            return 0.0
+        r = f32(f32(a4) / f32(a2))
+        c = f32(f32(r + f32(math.sqrt(f32(f32(r * r) + 8.0)))) * 0.25)
+        if c >= 1.0:
+            return 0.0
+        return f32(f32(f32(4.0 * math.pi) * self.bin_us) / f32(math.acos(c)))
+
+    def _close(self):
+        if self.bin_n == 0:
+            self.prev, self.d = None, []
+            return
+        num = self.bin_sum * 16
+        mean = abs(num) // self.bin_n * (1 if num >= 0 else -1)
+        self.bin_sum = self.bin_n = 0
+        if self.prev is None:
+            self.prev = mean
+            return
+        self.d = ([mean - self.prev] + self.d)[:9]
+        self.prev = mean
+        if len(self.d) < 9:
+            return
+        m = self.d[4]
+        p2, p4 = m * (self.d[2] + self.d[6]), m * (self.d[0] + self.d[8])
+        self.a2 += p2 - (self.a2 >> self.shift)
+        self.a4 += p4 - (self.a4 >> self.shift)
+        self.s2 = f32(self.s2 + f32(p2))
+        self.s4 = f32(self.s4 + f32(p4))
+        self.period_us = self._solve(self.a2, self.a4) or self.period_us
+        self.run_period_us = self._solve(self.s2, self.s4) or self.run_period_us
+
+    def push(self, t_us, counts):
+        if self.bin_start is None:
+            self.bin_start = t_us
+        while t_us - self.bin_start >= self.bin_us:
+            self._close()
+            self.bin_start += self.bin_us
+        self.bin_sum += counts
+        self.bin_n += 1
+
+
+def tracked(ev, n_half):
+    return ev[n_half] if len(ev) > n_half else None
+
+
+def endpoint(ev, n_half):
+    if len(ev) <= n_half:
+        return None
+    return (ev[n_half] - ev[0]) / (n_half / 2.0)
+
+
+def lsq(ev, n_half):
+    """t_k = a + k*h + b*(-1)^k, k = 0..n_half → T = 2h"""
+    if len(ev) <= n_half or n_half < 2:
+        return None
+    s = [[0.0] * 3 for _ in range(3)]
+    r = [0.0] * 3
+    for k in range(n_half + 1):
+        x = (1.0, float(k), 1.0 if k % 2 == 0 else -1.0)
+        for i in range(3):
+            r[i] += x[i] * ev[k]
+            for j in range(3):
+                s[i][j] += x[i] * x[j]
+    sol = _solve3(s, r)
+    return None if sol is None else 2.0 * sol[1]
+
+
+def _solve3(a, b):
+    m = [row[:] + [b[i]] for i, row in enumerate(a)]
+    for c in range(3):
+        p = max(range(c, 3), key=lambda i: abs(m[i][c]))
+        if abs(m[p][c]) < 1e-12:
+            return None
+        m[c], m[p] = m[p], m[c]
+        for i in range(3):
+            if i != c:
+                f = m[i][c] / m[c][c]
+                for j in range(c, 4):
+                    m[i][j] -= f * m[c][j]
+    return [m[i][3] / m[i][i] for i in range(3)]
@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+# 세션 기록 재생 + 결과 비교 (보드에서 확인할 때만: 보관함 회귀 시험은 tools/replay_native.py, 보드 없이)
+#
+# 기록: 보통 펌웨어에서 Serial 'R' → 측정 → 'r', 모니터 출력을 파일로 저장 (rec,begin ~ rec,end).
+# 재생: [env:uno_replay] 보드에 r/d 줄을 한 줄씩 보내고 (ack 받으면 다음 줄) 나온 swing/result 줄을
+#       기록 파일 안의 swing/result 줄과 비교. 보드를 여러 개 주면 기록들을 나눠서 동시에 돌림.
+#       기록의 clk 줄(시간 기준 보정값)도 보냄 → 재생 보드는 자기 EEPROM 대신 그 값으로 주기를 계산.
+#       r/d 줄 끝의 상태 지문이 보드에서 다시 계산한 것과 다르면 보드가 "crc,<기록>,<재생>"을 냄 → 실패로 셈.
+#
+#   python3 tools/replay.py --port /dev/ttyACM0 --port /dev/ttyACM1 sessions/*.log
+#
+# 하나라도 다르면 종료 코드 1.
+import argparse
+import queue
+import sys
+import threading
+import time
+
+import serial  # pyserial
+
+COMPARED = ("swing,", "result,")
+MISMATCH = "crc,"  # 기록에는 없는 줄이라 나오면 비교에서 다름
+
+
+def load(path):
+    inputs, expected = [], []
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if line == "rec,begin" or line.startswith(("r,", "d,", "clk,")):  # d: 직전 줄과의 차이, clk: 보정값
+                inputs.append(line)
+            elif line.startswith(COMPARED):
+                expected.append(line)
+    return inputs, expected
+
+
+def replay(port, baud, inputs):
+    out = []
+    with serial.Serial(port, baud, timeout=5) as s:
+        time.sleep(2.0)  # 포트 열면 보드 리셋 → 부팅 대기
+        s.reset_input_buffer()
+        for line in inputs:
+            s.write((line + "\n").encode())
+            while True:
+                got = s.readline().decode(errors="replace").strip()
+                if not got:
+                    raise RuntimeError("%s: no ack for %r" % (port, line))
+                if got == "ack":
+                    break
+                if got.startswith(COMPARED) or got.startswith(MISMATCH):
+                    out.append(got)
+    return out
+
+
+def worker(port, baud, jobs, results):
+    while True:
+        try:
+            path = jobs.get_nowait()
+        except queue.Empty:
+            return
+        inputs, expected = load(path)
+        try:
+            got = replay(port, baud, inputs)
+            results.append((path, got == expected, expected, got))
+        except Exception as e:  # 보드/포트 문제도 실패로 기록
+            results.append((path, False, expected, [str(e)]))
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--port", action="append", required=True)
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("sessions", nargs="+")
+    args = ap.parse_args()
+
+    jobs = queue.Queue()
+    for p in args.sessions:
+        jobs.put(p)
+    results = []
+    threads = [threading.Thread(target=worker, args=(p, args.baud, jobs, results)) for p in args.port]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    failed = 0
+    for path, ok, expected, got in sorted(results):
+        print("%s %s" % ("PASS" if ok else "FAIL", path))
+        if not ok:
+            failed += 1
+            for e, g in zip(expected + [""] * len(got), got + [""] * len(expected)):
+                if e != g:
+                    print("  expected %r, got %r" % (e, g))
+    print("replay,%d,%d" % (len(results) - failed, failed))
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+# 세션 기록 보관함을 보드 없이 재생 (회귀 시험): [env:native_replay] 프로그램(src/ReplayHost.cpp)을 여러 개 동시에 돌림
+#
+#   pio run -e native_replay                                 (프로그램 빌드, 또는 --build)
+#   python3 tools/replay_native.py sessions/                 (디렉터리면 그 아래 *.log 전부)
+#   python3 tools/replay_native.py --jobs 8 --lcd a.log b.log
+#
+# 기록: 보통 펌웨어에서 Serial 'R' → 측정 → 'r', 모니터 출력을 파일로 저장 (rec,begin ~ rec,end).
+# 프로그램이 기록마다 패스별 상태 지문(r/d 줄 끝 "*<crc>")과 swing/result 줄을 비교 → 출력 형식은 ReplayHost.cpp 머리말.
+# 기록들을 묶음으로 나눠 프로세스마다 한 묶음 (작업자 --jobs개가 동시에).
+# 출력: 기록마다 프로그램 줄 그대로 (실패한 기록은 crc/out/lcd 줄 포함, 파일 이름순)
+#       suite,<기록 수>,<통과>,<실패>,<기록 시간 s 합>,<재생 s>,<배속>,<jobs>
+# 하나라도 실패하면 종료 코드 1. 보드에서 확인할 때는 tools/replay.py ([env:uno_replay]).
+import argparse
+import concurrent.futures
+import multiprocessing
+import os
+import subprocess
+import sys
+import time
+
+DEFAULT_BIN = os.path.join(".pio", "build", "native_replay", "program")
+
+
+def find_sessions(paths):
+    found = []
+    for p in paths:
+        if os.path.isdir(p):
+            for root, _, files in os.walk(p):
+                found += [os.path.join(root, f) for f in files if f.endswith(".log")]
+        else:
+            found.append(p)
+    return sorted(found)
+
+
+def run_batch(binary, batch, lcd):
+    """묶음 하나 → [(경로, 통과 여부, 출력 줄들)]"""
+    cmd = [binary] + (["--lcd"] if lcd else []) + batch
+    proc = subprocess.run(cmd, stdout=subprocess.PIPE, universal_newlines=True)
+    results, pending = [], []
+    for line in proc.stdout.splitlines():
+        pending.append(line)
+        if line.startswith("replay,"):
+            parts = line.rsplit(",", 7)  # 경로에 ','가 있어도 뒤 7칸은 숫자/상태
+            results.append((parts[0][len("replay,"):], parts[1] == "ok", pending))
+            pending = []
+    if len(results) != len(batch):  # 프로그램이 도중에 죽음
+        done = {r[0] for r in results}
+        results += [(p, False, pending + ["replay,%s,fail (exit %d)" % (p, proc.returncode)])
+                    for p in batch if p not in done]
+    return results
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("sessions", nargs="+", help="기록 파일 또는 디렉터리")
+    ap.add_argument("--bin", default=DEFAULT_BIN, help="재생 프로그램 (기본: pio run -e native_replay 결과)")
+    ap.add_argument("--build", action="store_true", help="먼저 pio run -e native_replay")
+    ap.add_argument("--jobs", type=int, default=multiprocessing.cpu_count())
+    ap.add_argument("--lcd", action="store_true", help="실패한 기록은 그때 LCD 화면도")
+    args = ap.parse_args()
+
+    if args.build:
+        subprocess.run(["pio", "run", "-e", "native_replay"], check=True)
+    if not os.path.exists(args.bin):
+        raise SystemExit("%s: not built (pio run -e native_replay, or --build)" % args.bin)
+    sessions = find_sessions(args.sessions)
+    if not sessions:
+        raise SystemExit("no session logs")
+
+    # 묶음 = 작업자당 4개 정도 (느린 기록 하나가 끝을 끌지 않게), 프로세스 띄우는 비용은 묶음마다 한 번
+    size = max(1, len(sessions) // (4 * args.jobs))
+    batches = [sessions[i:i + size] for i in range(0, len(sessions), size)]
+    start = time.perf_counter()
+    with concurrent.futures.ThreadPoolExecutor(args.jobs) as pool:
+        done = pool.map(lambda b: run_batch(args.bin, b, args.lcd), batches)
+        results = sorted(r for batch in done for r in batch)
+    elapsed = time.perf_counter() - start
+
+    failed, recorded = 0, 0.0
+    for path, ok, lines in results:
+        if not ok:
+            failed += 1
+        for line in lines:
+            print(line)
+        try:
+            recorded += float(lines[-1].rsplit(",", 7)[5])
+        except (IndexError, ValueError):
+            pass
+    print("suite,%d,%d,%d,%.1f,%.3f,%.0f,%d" % (len(results), len(results) - failed, failed, recorded,
+                                                 elapsed, recorded / elapsed if elapsed > 0 else 0.0, args.jobs))
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+# 측정대 여러 대 흉내 (pty): rig_daemon.py 수집 처리량/지연 벤치마크용
+#
+#   python3 tools/rig_emulator.py --rigs 8 --rate 500 --seconds 10 --send-log /tmp/send.csv
+#
+# pty를 rigs개 열고 슬레이브 경로를 한 줄씩 stdout에 낸 뒤, stdin에 "go"가 오면 시작.
+# 각 pty에 초당 rate줄씩 다중 게이트 빌드와 같은 결과 줄을 씀 (채널을 돌아가며, 실행 번호 증가):
+#   rig,<채널>,<핀>,<실행>,<왕복 수>,<T_s>,<sT_s>,<버린 엣지 수>
+# 끝나면 보낸 시각을 send-log에 씀:
+#   <rig 번호>,<채널>,<실행>,<time.monotonic_ns()>
+# 그다음 "done,<rig당 줄 수>"를 내고 stdin에 "close"가 오면 pty를 닫음
+# (마스터를 먼저 닫으면 슬레이브 쪽에 남은 입력이 버려질 수 있음)
+import argparse
+import os
+import pty
+import random
+import sys
+import time
+import tty
+
+CHANNELS = 6
+PINS = (2, 3, 4, 5, 6, 7)  # include/Pins.h GATE_RIG_PINS
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--rigs", type=int, default=4)
+    ap.add_argument("--rate", type=float, default=100.0, help="rig 하나가 초당 쓰는 줄 수")
+    ap.add_argument("--seconds", type=float, default=5.0)
+    ap.add_argument("--send-log", required=True)
+    ap.add_argument("--seed", type=int, default=1)
+    args = ap.parse_args()
+
+    rng = random.Random(args.seed)
+    masters = []
+    for _ in range(args.rigs):
+        m, s = pty.openpty()
+        tty.setraw(s)
+        masters.append((m, s))
+        print(os.ttyname(s))
+    sys.stdout.flush()
+    if sys.stdin.readline().strip() != "go":
+        return
+
+    periods = [[rng.uniform(0.8, 2.4) for _ in range(CHANNELS)] for _ in masters]
+    log = []
+    interval = 1.0 / args.rate
+    start = time.monotonic()
+    k = 0
+    while True:
+        target = start + k * interval
+        if target - start >= args.seconds:
+            break
+        now = time.monotonic()
+        if target > now:
+            time.sleep(target - now)
+        ch, run = k % CHANNELS, k // CHANNELS + 1
+        for i, (m, _) in enumerate(masters):
+            T = periods[i][ch] * (1.0 + rng.gauss(0.0, 1e-4))
+            line = "rig,%d,%d,%d,10,%.6f,%.7f,0\n" % (ch, PINS[ch], run, T, T * 2e-5)
+            log.append((i, ch, run, time.monotonic_ns()))
+            os.write(m, line.encode())
+        k += 1
+
+    with open(args.send_log, "w") as f:
+        for rec in log:
+            f.write("%d,%d,%d,%d\n" % rec)
+    print("done,%d" % k)
+    sys.stdout.flush()
+    sys.stdin.readline()
+    for m, s in masters:
+        os.close(m)
+        os.close(s)
+
+
+if __name__ == "__main__":
+    main()
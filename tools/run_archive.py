@@ -0,0 +1,530 @@
+#!/usr/bin/env python3
+# 측정 기록 열(column) 보관 파일: 실행(run)과 왕복(swing)을 블록 단위로 덧붙이고, mmap으로 바로 읽어서 거름/집계
+#
+#   python3 tools/run_archive.py add history.rar rigs/*.log --profile m0.50_d0.30   (기록 파일을 보관 파일에 추가)
+#   python3 tools/run_archive.py query history.rar --rig ttyACM0 --since 2026-01-01 --until 2026-03-31 --group profile
+#   python3 tools/run_archive.py bench --runs 20000 --rigs 8                        (텍스트 다시 읽기와 훑기 속도 비교)
+#
+# 읽는 기록 (한 파일 안에 섞여도 됨):
+#   rig_daemon.py 기록 "<수신 unix ns>,<줄>", Serial 캡처 그대로의 펌웨어 줄 (swing/amp_corr/result/rig),
+#   extra codes/photo_final.cpp 출력 (줄마다 "T<TAB>", "NA", 끝에 SUMMARY의 T_avg / I_avg)
+#   실행 경계 = swing,1 / PHOTO MODE 머리줄 / rig 줄 하나. result는 바로 앞 실행에 붙음 (같은 result 반복은 무시).
+#   시각: daemon 기록이면 받은 시각, 아니면 파일 수정 시각. 왕복 시각 = 실행 시각 - 뒤 왕복 주기 합.
+#   왕복 진폭: amp_corr 첫/끝 진폭 사이를 지수 감쇠로 채움 (없으면 NaN)
+#
+# 파일: 머리 16바이트 (MAGIC) 뒤로 블록만 이어 붙임 (덧붙이기 전용, 기존 바이트는 안 고침)
+#   블록 머리 24바이트 '<4sBBHIQ4x': b'RBLK', 표 번호, 열 수, 0, 행 수, 머리 뒤 바이트 수
+#   이름 블록(표 0): utf-8 이름을 '\n'으로 이음. 파일 전체에서 나온 순서 = 번호 (rig/profile 열이 이 번호)
+#   열 블록(표 1 runs, 2 swings): 열마다 (min, max) 16바이트 → 열 배열을 차례로 (각 8바이트 경계, 리틀 엔디언)
+#   쓰다 끊긴 마지막 블록(바이트 부족)은 읽을 때 무시, 다음 add가 잘라내고 이어 씀.
+# 읽기: 블록 머리만 훑어서 위치를 잡고, 열은 mmap 조각을 memoryview.cast (numpy가 있으면 frombuffer)로 복사 없이 씀.
+#   거름 조건이 블록 min/max 범위 밖이면 블록을 통째로 건너뜀.
+# 출력: agg,<표>,<묶음>,<행 수>,<T 평균>,<T 표준편차>,<T 최소>,<T 최대>,<진폭 평균>,<I 평균(runs만)>
+#       scan,<표>,<블록 수>,<건너뛴 블록 수>,<훑은 행 수>,<초>
+#       scanbench,<행 수>,<텍스트 MB>,<보관 MB>,<텍스트 s>,<보관 s>,<텍스트 행/s>,<보관 행/s>,<배율>,<같음 1/0>,<numpy|python>
+import argparse
+import calendar
+import math
+import mmap
+import os
+import random
+import struct
+import tempfile
+import time
+
+try:
+    import numpy as np
+except ImportError:  # 순수 파이썬으로도 돌지만 느림
+    np = None
+
+MAGIC = b"RUNARCH\x01\0\0\0\0\0\0\0\0"
+BLOCK = struct.Struct("<4sBBHIQ4x")
+T_NAMES, T_RUNS, T_SWINGS = 0, 1, 2
+TABLE_NAMES = {"runs": T_RUNS, "swings": T_SWINGS}
+SCHEMA = {
+    T_RUNS: (("t_ns", "q"), ("rig", "i"), ("profile", "i"), ("run", "i"), ("ch", "i"), ("swings", "i"),
+             ("T", "d"), ("T0", "d"), ("amp_first", "d"), ("amp_last", "d"),
+             ("mass", "d"), ("dist", "d"), ("I", "d"), ("sigma_I", "d")),
+    T_SWINGS: (("t_ns", "q"), ("rig", "i"), ("profile", "i"), ("run", "i"), ("k", "i"),
+               ("T", "d"), ("amp", "d")),
+}
+NAN = float("nan")
+
+
+def pad8(n):
+    return (n + 7) & ~7
+
+
+# ----- 텍스트 기록 → 실행 -----
+def new_run(t_ns, ch=-1):
+    return {"t_ns": t_ns, "ch": ch, "periods": [], "T": NAN, "T0": NAN, "amp_first": NAN, "amp_last": NAN,
+            "mass": NAN, "dist": NAN, "I": NAN, "sigma_I": NAN, "result": False}
+
+
+def parse_log(path):
+    """기록 파일 하나 → 실행 dict 목록 (읽는 순서)"""
+    mtime_ns = os.stat(path).st_mtime_ns
+    runs, cur, last_result = [], None, None
+    with open(path, errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            if not line:
+                continue
+            t_ns = mtime_ns
+            head, _, rest = line.partition(",")
+            if head.isdigit() and len(head) >= 16:  # rig_daemon 기록
+                t_ns, line = int(head), rest
+            if "\t" in line or line == "NA":  # photo_final 주기 줄
+                if cur is None:
+                    cur = new_run(t_ns)
+                    runs.append(cur)
+                v = line.split("\t")[0]
+                if v != "NA":
+                    cur["periods"].append(float(v))
+                continue
+            parts = line.split(",")
+            try:
+                if parts[0] == "swing" and len(parts) == 3:
+                    if cur is None or parts[1] == "1" or cur["result"]:
+                        cur = new_run(t_ns)
+                        runs.append(cur)
+                    cur["periods"].append(float(parts[2]))
+                elif parts[0] == "amp_corr" and len(parts) == 5 and cur is not None:
+                    cur["amp_first"], cur["amp_last"], cur["T"], cur["T0"] = (float(x) for x in parts[1:])
+                elif parts[0] == "result" and len(parts) == 6:
+                    if line == last_result:
+                        continue
+                    last_result = line
+                    if cur is None or cur["result"]:
+                        cur = new_run(t_ns)
+                        runs.append(cur)
+                    cur["result"] = True
+                    cur["T"], cur["mass"], cur["dist"], cur["I"], cur["sigma_I"] = (float(x) for x in parts[1:])
+                elif parts[0] == "rig" and len(parts) == 8:
+                    r = new_run(t_ns, int(parts[1]))
+                    r["swings"], r["T"] = int(parts[4]), float(parts[5])
+                    runs.append(r)
+                    cur = None
+                elif line.startswith("=== PHOTO MODE"):
+                    cur = new_run(t_ns)
+                    runs.append(cur)
+                elif line.startswith("T_avg") and cur is not None:
+                    cur["T"] = float(line.split(":")[1])
+                elif line.startswith("I_avg") and cur is not None:
+                    cur["I"] = float(line.split(":")[1])
+                    cur["result"] = True
+            except ValueError:  # 끊긴 줄
+                continue
+    for r in runs:
+        p = r["periods"]
+        r.setdefault("swings", len(p))
+        if p and math.isnan(r["T"]):
+            r["T"] = sum(p) / len(p)
+    return runs
+
+
+def swing_rows(r):
+    """실행 하나의 왕복 (t_ns, k, T, amp)"""
+    p = r["periods"]
+    n = len(p)
+    a0, a1 = r["amp_first"], r["amp_last"]
+    decay = math.log(a1 / a0) / (n - 1) if n > 1 and a0 > 0 and a1 > 0 else 0.0
+    t, rows = r["t_ns"], []
+    for k in range(n, 0, -1):
+        rows.append((t, k, p[k - 1], a0 * math.exp(decay * (k - 1))))
+        t -= int(p[k - 1] * 1e9)
+    rows.reverse()
+    return rows
+
+
+# ----- 읽기 -----
+class Block:
+    __slots__ = ("table", "rows", "offset", "stats", "cols")
+
+
+class Archive:
+    def __init__(self, path):
+        self.names, self.blocks = [], []
+        self._f = open(path, "rb")
+        size = os.fstat(self._f.fileno()).st_size
+        self._mm = mmap.mmap(self._f.fileno(), 0, access=mmap.ACCESS_READ) if size else b""
+        self._view = memoryview(self._mm)
+        if size < len(MAGIC) or self._mm[:len(MAGIC)] != MAGIC:
+            raise SystemExit("%s: not a run archive" % path)
+        pos = len(MAGIC)
+        while pos + BLOCK.size <= size:
+            magic, table, ncols, _, rows, length = BLOCK.unpack_from(self._mm, pos)
+            body = pos + BLOCK.size
+            if magic != b"RBLK" or body + length > size:
+                break  # 쓰다 끊긴 블록
+            if table == T_NAMES:
+                if length:
+                    self.names += bytes(self._view[body:body + length]).decode().split("\n")
+            elif table in SCHEMA and ncols == len(SCHEMA[table]):
+                self.blocks.append(self._layout(table, rows, body))
+            pos = body + length
+        self.end = pos  # 마지막 온전한 블록 끝
+        self.ids = {n: i for i, n in enumerate(self.names)}
+
+    def _layout(self, table, rows, body):
+        b = Block()
+        b.table, b.rows, b.offset, b.stats, b.cols = table, rows, body, {}, {}
+        schema = SCHEMA[table]
+        off = body + 16 * len(schema)
+        for i, (name, code) in enumerate(schema):
+            lo, hi = struct.unpack_from("<qq" if code in "qi" else "<dd", self._mm, body + 16 * i)
+            b.stats[name] = (lo, hi)
+            b.cols[name] = (off, code)
+            off += pad8(rows * struct.calcsize(code))
+        return b
+
+    def column(self, b, name):
+        off, code = b.cols[name]
+        size = b.rows * struct.calcsize(code)
+        if np is not None:
+            return np.frombuffer(self._mm, dtype="<" + ("i8" if code == "q" else "i4" if code == "i" else "f8"),
+                                 count=b.rows, offset=off)
+        return self._view[off:off + size].cast(code)
+
+    def max_run(self):
+        runs = [b.stats["run"][1] for b in self.blocks]
+        return max(runs) if runs else 0
+
+    def close(self):
+        self._view.release()
+        if self._mm:
+            self._mm.close()
+        self._f.close()
+
+
+# ----- 쓰기 -----
+class Writer:
+    def __init__(self, path, block_rows):
+        self.block_rows = block_rows
+        if os.path.exists(path) and os.path.getsize(path) > 0:
+            a = Archive(path)
+            self.names, self.next_run, end = list(a.names), a.max_run() + 1, a.end
+            a.close()
+            os.truncate(path, end)  # 끊긴 블록 뒤에 붙이면 읽을 수 없으므로 잘라냄
+        else:
+            with open(path, "wb") as f:
+                f.write(MAGIC)
+            self.names, self.next_run = [], 1
+        self.ids = {n: i for i, n in enumerate(self.names)}
+        self.new_names = []
+        self.pending = {T_RUNS: [], T_SWINGS: []}
+        self.f = open(path, "ab")
+
+    def name_id(self, name):
+        if name not in self.ids:
+            self.ids[name] = len(self.names)
+            self.names.append(name)
+            self.new_names.append(name)
+        return self.ids[name]
+
+    def add_run(self, rig, profile, r):
+        rig_id, prof_id = self.name_id(rig), self.name_id(profile)
+        run = self.next_run
+        self.next_run += 1
+        self._row(T_RUNS, (r["t_ns"], rig_id, prof_id, run, r["ch"], r["swings"], r["T"], r["T0"],
+                           r["amp_first"], r["amp_last"], r["mass"], r["dist"], r["I"], r["sigma_I"]))
+        for t_ns, k, T, amp in swing_rows(r):
+            self._row(T_SWINGS, (t_ns, rig_id, prof_id, run, k, T, amp))
+
+    def _row(self, table, row):
+        rows = self.pending[table]
+        rows.append(row)
+        if len(rows) >= self.block_rows:
+            self._flush(table)
+
+    def _flush(self, table):
+        rows = self.pending[table]
+        if not rows:
+            return
+        if self.new_names:  # 블록보다 먼저 (읽을 때 이름 번호가 이미 있도록)
+            data = "\n".join(self.new_names).encode()
+            self.f.write(BLOCK.pack(b"RBLK", T_NAMES, 0, 0, len(self.new_names), len(data)) + data)
+            self.new_names = []
+        schema = SCHEMA[table]
+        stats, cols = [], []
+        for i, (_, code) in enumerate(schema):
+            col = [r[i] for r in rows]
+            vals = [v for v in col if v == v]  # NaN 빼고 (정수 열은 그대로)
+            lo, hi = (min(vals), max(vals)) if vals else (NAN, NAN)
+            stats.append(struct.pack("<qq" if code in "qi" else "<dd", lo, hi))
+            raw = struct.pack("<%d%s" % (len(col), code), *col)
+            cols.append(raw + b"\0" * (pad8(len(raw)) - len(raw)))
+        body = b"".join(stats) + b"".join(cols)
+        self.f.write(BLOCK.pack(b"RBLK", table, len(schema), 0, len(rows), len(body)) + body)
+        self.pending[table] = []
+
+    def close(self):
+        self._flush(T_RUNS)
+        self._flush(T_SWINGS)
+        self.f.close()
+
+
+def rig_name(path):
+    return os.path.splitext(os.path.basename(path))[0]
+
+
+def add_logs(archive, logs, rig, profile, block_rows):
+    w = Writer(archive, block_rows)
+    n = 0
+    for path in logs:
+        for r in parse_log(path):
+            prof = profile or ("m%.2f_d%.2f" % (r["mass"], r["dist"]) if r["result"] and r["mass"] == r["mass"]
+                               else "-")
+            w.add_run(rig or rig_name(path), prof, r)
+            n += 1
+    w.close()
+    return n
+
+
+# ----- 거름/집계 -----
+class Agg:
+    __slots__ = ("n", "s", "s2", "lo", "hi", "amp", "namp", "I", "nI")
+
+    def __init__(self):
+        self.n = self.namp = self.nI = 0
+        self.s = self.s2 = self.amp = self.I = 0.0
+        self.lo, self.hi = math.inf, -math.inf
+
+    def add(self, T, amp, I):
+        self.n += 1
+        self.s += T
+        self.s2 += T * T
+        self.lo, self.hi = min(self.lo, T), max(self.hi, T)
+        if amp == amp:
+            self.amp += amp
+            self.namp += 1
+        if I == I:
+            self.I += I
+            self.nI += 1
+
+    def merge(self, n, s, s2, lo, hi, amp, namp, I, nI):
+        self.n += n
+        self.s += s
+        self.s2 += s2
+        self.lo, self.hi = min(self.lo, lo), max(self.hi, hi)
+        self.amp += amp
+        self.namp += namp
+        self.I += I
+        self.nI += nI
+
+    def row(self):
+        mean = self.s / self.n
+        var = (self.s2 - self.s * mean) / (self.n - 1) if self.n > 1 else 0.0
+        return (self.n, mean, math.sqrt(max(0.0, var)), self.lo, self.hi,
+                self.amp / self.namp if self.namp else NAN, self.I / self.nI if self.nI else NAN)
+
+
+class Filter:
+    def __init__(self, rigs=None, profiles=None, since_ns=None, until_ns=None):
+        self.rigs, self.profiles = rigs, profiles
+        self.since, self.until = since_ns, until_ns
+
+    def match(self, rig, profile, t_ns):
+        return ((self.rigs is None or rig in self.rigs) and (self.profiles is None or profile in self.profiles)
+                and (self.since is None or t_ns >= self.since) and (self.until is None or t_ns < self.until))
+
+
+def query(a, table, flt, group):
+    """보관 파일 훑기 → {묶음 이름: Agg}, (블록 수, 건너뛴 수, 훑은 행 수)"""
+    rigs = None if flt.rigs is None else {a.ids[n] for n in flt.rigs if n in a.ids}
+    profiles = None if flt.profiles is None else {a.ids[n] for n in flt.profiles if n in a.ids}
+    out, nblocks, skipped, scanned = {}, 0, 0, 0
+    for b in a.blocks:
+        if b.table != table:
+            continue
+        nblocks += 1
+        st = b.stats
+        if ((rigs is not None and not any(st["rig"][0] <= i <= st["rig"][1] for i in rigs))
+                or (profiles is not None and not any(st["profile"][0] <= i <= st["profile"][1] for i in profiles))
+                or (flt.since is not None and st["t_ns"][1] < flt.since)
+                or (flt.until is not None and st["t_ns"][0] >= flt.until)):
+            skipped += 1
+            continue
+        scanned += b.rows
+        rig, prof, t = a.column(b, "rig"), a.column(b, "profile"), a.column(b, "t_ns")
+        T = a.column(b, "T")
+        amp = a.column(b, "amp_first" if table == T_RUNS else "amp")
+        I = a.column(b, "I") if table == T_RUNS else None
+        key = a.column(b, group) if group != "none" else None
+        if np is not None:
+            m = ~np.isnan(T)
+            if rigs is not None:
+                m &= np.isin(rig, list(rigs))
+            if profiles is not None:
+                m &= np.isin(prof, list(profiles))
+            if flt.since is not None:
+                m &= t >= flt.since
+            if flt.until is not None:
+                m &= t < flt.until
+            for g in (np.unique(key[m]) if key is not None else [None]):
+                mg = m & (key == g) if key is not None else m
+                Tg = T[mg]
+                if not len(Tg):
+                    continue
+                ag, Ig = amp[mg], I[mg] if I is not None else np.empty(0)
+                ok_a, ok_i = ~np.isnan(ag), ~np.isnan(Ig)
+                out.setdefault(a.names[int(g)] if g is not None else "all", Agg()).merge(
+                    len(Tg), float(Tg.sum()), float((Tg * Tg).sum()), float(Tg.min()), float(Tg.max()),
+                    float(ag[ok_a].sum()), int(ok_a.sum()), float(Ig[ok_i].sum()), int(ok_i.sum()))
+        else:
+            for j in range(b.rows):
+                if T[j] != T[j] or not (
+                        (rigs is None or rig[j] in rigs) and (profiles is None or prof[j] in profiles)
+                        and (flt.since is None or t[j] >= flt.since) and (flt.until is None or t[j] < flt.until)):
+                    continue
+                g = a.names[key[j]] if key is not None else "all"
+                out.setdefault(g, Agg()).add(T[j], amp[j], I[j] if I is not None else NAN)
+    return out, (nblocks, skipped, scanned)
+
+
+def query_text(logs, table, flt, group, profile_of):
+    """같은 질의를 텍스트 기록을 다시 읽어서 (비교용)"""
+    out = {}
+    for path in logs:
+        rig = rig_name(path)
+        for r in parse_log(path):
+            prof = profile_of(r)
+            if table == T_RUNS:
+                if r["T"] == r["T"] and flt.match(rig, prof, r["t_ns"]):
+                    g = rig if group == "rig" else prof if group == "profile" else "all"
+                    out.setdefault(g, Agg()).add(r["T"], r["amp_first"], r["I"])
+                continue
+            for t_ns, _, T, amp in swing_rows(r):
+                if flt.match(rig, prof, t_ns):
+                    g = rig if group == "rig" else prof if group == "profile" else "all"
+                    out.setdefault(g, Agg()).add(T, amp, NAN)
+    return out
+
+
+def print_aggs(table, aggs):
+    for g in sorted(aggs):
+        print("agg,%s,%s,%d,%.6f,%.3g,%.6f,%.6f,%.2f,%.6f" % ((table, g) + aggs[g].row()))
+
+
+def day_ns(s):
+    return calendar.timegm(time.strptime(s, "%Y-%m-%d")) * 1000000000
+
+
+# ----- 벤치마크: 합성 daemon 기록 -----
+def write_synthetic(out_dir, runs, rigs, swings, days, seed):
+    """rig마다 시간 순 daemon 기록. 실행마다 swing × N, amp_corr, result (프로필 = 질량/거리 4가지)"""
+    rng = random.Random(seed)
+    t0 = day_ns("2026-01-01")
+    configs = [(0.5, 0.3), (0.5, 0.4), (1.0, 0.3), (1.0, 0.4)]
+    paths = []
+    for i in range(rigs):
+        path = os.path.join(out_dir, "rig%02d.log" % i)
+        paths.append(path)
+        n = runs // rigs
+        step = days * 86400 * 1000000000 // n
+        with open(path, "w") as f:
+            for j in range(n):
+                m, d = configs[rng.randrange(len(configs))]
+                T = 0.9 + 0.8 * d + 0.1 * m + rng.gauss(0, 0.002)
+                a0 = rng.uniform(8, 20)
+                t = t0 + j * step + rng.randrange(step // 2)
+                for k in range(1, swings + 1):
+                    f.write("%d,swing,%d,%.6f\n" % (t, k, T * (1 + rng.gauss(0, 2e-4))))
+                a1 = a0 * math.exp(-0.02 * (swings - 1))
+                f.write("%d,amp_corr,%.2f,%.2f,%.6f,%.6f\n" % (t, a0, a1, T, T * 0.998))
+                f.write("%d,result,%.6f,%.2f,%.2f,%.6f,%.6f\n" % (t + 1000, T, m, d, m * d * d, 1e-5))
+    return paths
+
+
+def same(x, y):
+    if x.keys() != y.keys():
+        return False
+    for g in x:
+        a, b = x[g].row(), y[g].row()
+        if a[0] != b[0] or any(abs(p - q) > 1e-9 * max(1.0, abs(p)) for p, q in zip(a[1:], b[1:])
+                               if not (p != p and q != q)):
+            return False
+    return True
+
+
+def bench(args):
+    with tempfile.TemporaryDirectory() as tmp:
+        logs = write_synthetic(tmp, args.runs, args.rigs, args.swings, args.days, args.seed)
+        arch = os.path.join(tmp, "bench.rar")
+        t = time.perf_counter()
+        add_logs(arch, logs, None, None, args.block_rows)
+        build_s = time.perf_counter() - t
+        text_mb = sum(os.path.getsize(p) for p in logs) / 1e6
+        arch_mb = os.path.getsize(arch) / 1e6
+
+        table = TABLE_NAMES[args.table]
+        # 질의: rig 절반, 90일, 프로필별
+        flt = Filter(rigs={"rig%02d" % i for i in range(0, args.rigs, 2)},
+                     since_ns=day_ns("2026-02-01"), until_ns=day_ns("2026-05-02"))
+
+        def profile_of(r):
+            return "m%.2f_d%.2f" % (r["mass"], r["dist"])
+
+        t = time.perf_counter()
+        ref = query_text(logs, table, flt, "profile", profile_of)
+        text_s = time.perf_counter() - t
+        t = time.perf_counter()
+        a = Archive(arch)
+        got, (nblocks, skipped, _) = query(a, table, flt, "profile")
+        arch_s = time.perf_counter() - t
+        rows = sum(b.rows for b in a.blocks if b.table == table)
+        a.close()
+    print("build,%d,%.2f" % (args.runs, build_s))
+    print("scan,%s,%d,%d" % (args.table, nblocks, skipped))
+    print_aggs(args.table, got)
+    print("scanbench,%d,%.1f,%.1f,%.3f,%.4f,%.0f,%.0f,%.0f,%d,%s" % (
+        rows, text_mb, arch_mb, text_s, arch_s, rows / text_s, rows / arch_s, text_s / arch_s,
+        1 if same(ref, got) else 0, "numpy" if np is not None else "python"))
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    sub = ap.add_subparsers(dest="cmd", required=True)
+    p = sub.add_parser("add", help="텍스트 기록 → 보관 파일에 덧붙임")
+    p.add_argument("archive")
+    p.add_argument("logs", nargs="+")
+    p.add_argument("--rig", help="rig 이름 (기본: 파일 이름)")
+    p.add_argument("--profile", help="프로필 이름 (기본: result의 질량/거리, 없으면 -)")
+    p.add_argument("--block-rows", type=int, default=8192)
+    p = sub.add_parser("query", help="거름 + 집계")
+    p.add_argument("archive")
+    p.add_argument("--table", choices=sorted(TABLE_NAMES), default="runs")
+    p.add_argument("--rig", action="append")
+    p.add_argument("--profile", action="append")
+    p.add_argument("--since", help="YYYY-MM-DD (UTC, 포함)")
+    p.add_argument("--until", help="YYYY-MM-DD (UTC, 그날 포함)")
+    p.add_argument("--group", choices=("none", "rig", "profile"), default="none")
+    p = sub.add_parser("bench", help="합성 기록으로 텍스트 다시 읽기 vs 보관 파일 훑기")
+    p.add_argument("--runs", type=int, default=20000)
+    p.add_argument("--rigs", type=int, default=8)
+    p.add_argument("--swings", type=int, default=30)
+    p.add_argument("--days", type=int, default=180)
+    p.add_argument("--table", choices=sorted(TABLE_NAMES), default="swings")
+    p.add_argument("--block-rows", type=int, default=8192)
+    p.add_argument("--seed", type=int, default=1)
+    args = ap.parse_args()
+
+    if args.cmd == "add":
+        n = add_logs(args.archive, args.logs, args.rig, args.profile, args.block_rows)
+        print("added,%d" % n)
+    elif args.cmd == "query":
+        flt = Filter(set(args.rig) if args.rig else None, set(args.profile) if args.profile else None,
+                     day_ns(args.since) if args.since else None,
+                     day_ns(args.until) + 86400 * 1000000000 if args.until else None)
+        t = time.perf_counter()
+        a = Archive(args.archive)
+        aggs, (nblocks, skipped, scanned) = query(a, TABLE_NAMES[args.table], flt, args.group)
+        a.close()
+        print_aggs(args.table, aggs)
+        print("scan,%s,%d,%d,%d,%.4f" % (args.table, nblocks, skipped, scanned, time.perf_counter() - t))
+    else:
+        bench(args)
+
+
+if __name__ == "__main__":
+    main()
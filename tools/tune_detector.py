@@ -0,0 +1,279 @@
+#!/usr/bin/env python3
+# 검출기 임계값 자동 튜닝 → include/DetectorParams.h 생성
+#
+#   python3 tools/tune_detector.py --runs 200                 (전체 탐색, 모든 코어)
+#   python3 tools/tune_detector.py --defaults                 (지금 손으로 정한 값으로 헤더만 다시 씀)
+#
+# 세 검출기를 따로 탐색 (goto만 hall의 ema_old에 기댐):
+#   hall  : Mode 5 피크 검출 (arm_deg, peak_deg, ema_old)  → 놓침률, 오검출률, 결과까지 시간
+#   goto  : Mode 3/5 "Go to" 각도 잡기 (tol_deg, hold_ms)  → 잡을 때까지 시간, 놓는 진폭 오차
+#           두 모드가 같은 매크로를 쓰므로 같은 손 움직임을 두 모드 규칙으로 돌려 평균:
+#           Mode 3 = 원시 각도, Mode 5 = 버티기 시작 뒤에만 EMA(hall ema_old). hall을 먼저 정하고 그 ema_old를 씀
+#   photo : Mode 3 포토 디바운스 (debounce_ms)             → 놓침률, 오검출률
+# 검출기마다 파레토 최적 집합을 헤더 주석으로 남기고, 그중 가중합이 가장 작은 점을 #define으로 씀.
+# 모든 값은 #ifndef로 감싸서 빌드 플래그(-DDET_...)로 덮어쓸 수 있음.
+# --only로 일부만 탐색하면 나머지 검출기는 지금 헤더의 값과 파레토 주석을 그대로 옮겨 씀.
+import argparse
+import itertools
+import math
+import multiprocessing
+import os
+import random
+import re
+
+import pendulum_sim as sim
+
+HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "include", "DetectorParams.h")
+SWING = 10  # src/main.cpp swing
+
+DEFAULTS = {
+    "hall": {"arm_deg": 6, "peak_deg": 12, "ema_old": 0.2},
+    "goto": {"tol_deg": 3.0, "hold_ms": 1500},
+    "photo": {"debounce_ms": 50},
+}
+
+GRID = {
+    "hall": {"arm_deg": [2, 4, 6, 8, 10], "peak_deg": [6, 8, 10, 12, 14, 16], "ema_old": [0.0, 0.2, 0.4, 0.6]},
+    "goto": {"tol_deg": [1.0, 2.0, 3.0, 4.0, 5.0], "hold_ms": [500, 1000, 1500, 2000]},
+    "photo": {"debounce_ms": [5, 10, 20, 50, 100, 200, 400]},
+}
+
+# 파레토 점 중 하나를 고르는 가중치 (목표 순서대로)
+WEIGHTS = {"hall": (1.0, 1.0, 0.01), "goto": (0.1, 1.0), "photo": (1.0, 1.0)}
+OBJECTIVES = {"hall": ("miss", "false", "ttr_s"), "goto": ("lock_s", "amp_err_deg"), "photo": ("miss", "false")}
+
+# 헤더의 매크로 이름과 설명 (검출기별, 쓰는 순서대로)
+MACROS = {
+    "hall": [("arm_deg", "DET_HALL_ARM_DEG", "currentIntAngle < 이 값 → 다음 피크 준비"),
+             ("peak_deg", "DET_HALL_PEAK_DEG", "prevIntAngle > 이 값에서 내려가면 피크"),
+             ("ema_old", "DET_HALL_EMA_OLD", "각도 EMA: 이전 값 가중치 (새 값 = 1 - 이 값)")],
+    "goto": [("tol_deg", "DET_GOTO_TOL_DEG", "목표 각도 허용 오차"),
+             ("hold_ms", "DET_GOTO_HOLD_MS", "허용 오차 안에서 버틸 시간")],
+    "photo": [("debounce_ms", "DET_PHOTO_DEBOUNCE_MS", "포토 통과 디바운스")],
+}
+
+
+def corpus_run(rng):
+    period = rng.uniform(0.8, 2.4)
+    run = sim.Run(rng, period=period, amp_deg=rng.uniform(8.0, 30.0), decay=rng.uniform(0.002, 0.05))
+    run.noise = rng.uniform(0.5, 3.0)
+    run.loop_hz = rng.uniform(60.0, 110.0)
+    return run
+
+
+def score_hall(p, rng):
+    run = corpus_run(rng)
+    half = 0.5 * run.period
+    n_true = 2 * SWING + 2
+    det = run.firmware_detections((n_true + 0.5) * half, run.loop_hz, run.noise, p)
+    truth = [k * half for k in range(1, n_true + 1)]
+    used = set()
+    false = 0
+    for t in det:
+        k = min(range(len(truth)), key=lambda i: abs(truth[i] - t))
+        if abs(truth[k] - t) < 0.25 * half and k not in used:
+            used.add(k)
+        else:
+            false += 1
+    ttr = det[n_true - 1] if len(det) >= n_true else None
+    return (n_true - len(used)) / n_true, false / n_true, ttr
+
+
+def goto_lock(angles, dt, target, p, ema_old):
+    """Go to 규칙 (src/main.cpp Mode 3/5 step 0): (잡은 시각, 그때 진폭 오차). ema_old None = Mode 3 (원시 각도)
+    Mode 5는 필터를 매 패스 갱신하되 아직 허용 오차 밖(stableStartTime == 0)이면 원시 값으로 다시 맞춤"""
+    filtered, since = 0.0, None
+    for i, angle in enumerate(angles):
+        t = (i + 1) * dt
+        a = abs(angle)
+        if ema_old is None:
+            filtered = a
+        else:
+            filtered = filtered * ema_old + a * (1.0 - ema_old)
+            if since is None:
+                filtered = a
+        if abs(target - filtered) < p["tol_deg"]:
+            since = t if since is None else since
+            if (t - since) * 1000.0 > p["hold_ms"]:
+                return t, abs(a - target)
+        else:
+            since = None
+    return len(angles) * dt, target
+
+
+def score_goto(p, rng, ema_old):
+    # 손으로 목표 각도까지 가져가서 버팀: 1초 램프 + 떨림(OU 과정), 100Hz 루프, 30초까지
+    target = rng.uniform(5.0, 25.0)
+    sigma, tau = rng.uniform(0.3, 2.0), rng.uniform(0.2, 1.0)
+    dt, wobble, angles = 0.01, 0.0, []
+    for i in range(3000):
+        t = (i + 1) * dt
+        wobble += -wobble * dt / tau + sigma * math.sqrt(2.0 * dt / tau) * rng.gauss(0.0, 1.0)
+        angles.append(target * min(1.0, t) + wobble)
+    m3 = goto_lock(angles, dt, target, p, None)
+    m5 = goto_lock(angles, dt, target, p, ema_old)
+    return 0.5 * (m3[0] + m5[0]), 0.5 * (m3[1] + m5[1])
+
+
+def score_photo(p, rng):
+    # 통과마다 엣지 1개 + 확률적으로 채터 엣지 (빔 가장자리), 50ms 디바운스와 같은 규칙
+    run = corpus_run(rng)
+    ev = run.gate_events(2 * SWING + 1, gate_deg=rng.uniform(-2.0, 2.0))
+    edges = []
+    for t in ev:
+        edges.append((t, True))
+        for _ in range(rng.choice((0, 0, 1, 2, 3))):
+            edges.append((t + rng.uniform(0.0005, 0.03), False))
+    edges.sort()
+    last, hits, false = -1.0, 0, 0
+    for t, real in edges:
+        if (t - last) * 1000.0 > p["debounce_ms"]:
+            last = t
+            if real:
+                hits += 1
+            else:
+                false += 1
+    n = len(ev)
+    return (n - hits) / n, false / n
+
+
+SCORERS = {"hall": score_hall, "goto": score_goto, "photo": score_photo}
+
+
+def evaluate(task):
+    kind, params, runs, seed, extra = task
+    scorer = SCORERS[kind]
+    sums = None
+    ttr_n = 0
+    for i in range(runs):
+        res = scorer(params, random.Random(seed * 7919 + i), *extra)
+        if kind == "hall":
+            miss, false, ttr = res
+            if ttr is not None:
+                ttr_n += 1
+            res = (miss, false, ttr or 0.0)
+        sums = list(res) if sums is None else [a + b for a, b in zip(sums, res)]
+    score = [s / runs for s in sums]
+    if kind == "hall":
+        score[2] = sums[2] / ttr_n if ttr_n else float("inf")
+    return kind, params, tuple(score)
+
+
+def pareto(points):
+    front = []
+    for p, s in points:
+        if not any(all(b <= a for a, b in zip(s, s2)) and s2 != s for _, s2 in points):
+            front.append((p, s))
+    # 점수가 같으면 파라미터로: imap_unordered 도착 순서와 상관없이 같은 헤더
+    return sorted(front, key=lambda x: (x[1], sorted(x[0].items())))
+
+
+def fmt(v):
+    return ("%.2f" % v) if isinstance(v, float) else str(v)
+
+
+def parse_value(text):
+    return float(text) if "." in text else int(text)
+
+
+def read_header():
+    """지금 헤더의 (값, 파레토 집합). 없거나 못 읽은 검출기는 빠짐"""
+    values, fronts = {}, {}
+    try:
+        with open(HEADER) as f:
+            text = f.read()
+    except OSError:
+        return values, fronts
+    for kind, macros in MACROS.items():
+        got = {}
+        for key, macro, _ in macros:
+            m = re.search(r"^#define\s+%s\s+(\S+)" % macro, text, re.M)
+            if m:
+                got[key] = parse_value(m.group(1))
+        if len(got) == len(macros):
+            values[kind] = got
+        m = re.search(r"^// %s 파레토 집합 \(.*\):\n((?://   .*\n)+)" % kind, text, re.M)
+        if m:
+            front = []
+            for line in m.group(1).splitlines():
+                p, s = line[5:].split(" -> ")
+                front.append(({k: parse_value(v) for k, v in (kv.split("=") for kv in p.split())},
+                              tuple(float(x) for x in s.split())))
+            fronts[kind] = front
+    return values, fronts
+
+
+def write_header(chosen, fronts):
+    lines = [
+        "#pragma once",
+        "",
+        "// ==================== 검출기 임계값 ====================",
+        "// 자동 생성: tools/tune_detector.py (손으로 고치지 말고 다시 생성)",
+        "// 각 값은 빌드 플래그로 덮어쓸 수 있음 (예: -DDET_HALL_PEAK_DEG=10)",
+    ]
+    for kind in ("hall", "goto", "photo"):
+        lines.append("")
+        front = fronts.get(kind)
+        if front:
+            lines.append("// %s 파레토 집합 (%s):" % (kind, ", ".join(OBJECTIVES[kind])))
+            for p, s in front:
+                lines.append("//   %s -> %s" % (" ".join("%s=%s" % (k, fmt(v)) for k, v in p.items()),
+                                                " ".join("%.3f" % x for x in s)))
+        else:
+            lines.append("// %s: 손으로 정한 값 (탐색 안 함)" % kind)
+        for key, macro, desc in MACROS[kind]:
+            v = chosen[kind][key]
+            lines += ["#ifndef " + macro,
+                      "#define %-24s %-6s // %s" % (macro, fmt(v), desc),
+                      "#endif"]
+    with open(HEADER, "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--runs", type=int, default=200)
+    ap.add_argument("--seed", type=int, default=1)
+    ap.add_argument("--only", choices=sorted(GRID), nargs="+", default=sorted(GRID))
+    ap.add_argument("--defaults", action="store_true")
+    ap.add_argument("--jobs", type=int, default=multiprocessing.cpu_count())
+    args = ap.parse_args()
+
+    chosen = {k: dict(v) for k, v in DEFAULTS.items()}
+    fronts = {}
+    if not args.defaults:
+        # 탐색하지 않는 검출기는 지금 헤더 그대로 (DEFAULTS로 되돌리지 않음)
+        values, old_fronts = read_header()
+        for kind in GRID:
+            if kind not in args.only:
+                chosen[kind] = values.get(kind, chosen[kind])
+                if kind in old_fronts:
+                    fronts[kind] = old_fronts[kind]
+        # goto는 hall의 ema_old를 쓰므로 hall(과 photo)을 먼저 정함
+        batches = [[k for k in ("hall", "photo") if k in args.only], [k for k in ("goto",) if k in args.only]]
+        with multiprocessing.Pool(args.jobs) as pool:
+            for batch in batches:
+                tasks = []
+                for kind in batch:
+                    extra = (chosen["hall"]["ema_old"],) if kind == "goto" else ()
+                    keys = sorted(GRID[kind])
+                    for values in itertools.product(*(GRID[kind][k] for k in keys)):
+                        p = dict(zip(keys, values))
+                        if kind == "hall" and p["arm_deg"] >= p["peak_deg"]:
+                            continue
+                        tasks.append((kind, p, args.runs, args.seed, extra))
+                points = {k: [] for k in batch}
+                for kind, p, s in pool.imap_unordered(evaluate, tasks):
+                    points[kind].append((p, s))
+                    print("score,%s,%s,%s" % (kind, " ".join("%s=%s" % (k, fmt(v)) for k, v in sorted(p.items())),
+                                              ",".join("%.4f" % x for x in s)))
+                for kind in batch:
+                    fronts[kind] = pareto(points[kind])
+                    w = WEIGHTS[kind]
+                    chosen[kind] = min(fronts[kind], key=lambda ps: sum(a * b for a, b in zip(w, ps[1])))[0]
+    write_header(chosen, fronts)
+    print("wrote", os.path.normpath(HEADER))
+
+
+if __name__ == "__main__":
+    main()